@@ -9,6 +9,12 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
 
 template<typename array_t>
 void assert_sorted_ascending([[maybe_unused]] const array_t& a) {
@@ -70,6 +76,16 @@ constexpr uint8_t SELECT_FAIL = 0xFF;
 /// \return the position of the k-th 1-bit (LSBF and zero-based),
 ///         or \ref SELECT_FAIL if no such bit exists
 inline constexpr uint8_t select1_u64(uint64_t v, uint8_t k) {
+    // pdep is chosen at compile time (-mbmi2 or -march=native on a BMI2 CPU),
+    // there is no runtime dispatch. AMD CPUs before Zen 3 implement pdep in
+    // microcode, where it is slower than the loop below.
+#ifdef __BMI2__
+    if(!std::is_constant_evaluated()) {
+        // deposit the k-th lowest bit of the mask at the k-th 1-bit of v
+        if(k == 0 || k > __builtin_popcountll(v)) return SELECT_FAIL;
+        return __builtin_ctzll(_pdep_u64(1ULL << (k - 1), v));
+    }
+#endif
     uint8_t pos = 0;
     while(v && k && pos < 64) {
         const size_t z = __builtin_ctzll(v)+1;
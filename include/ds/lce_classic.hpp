@@ -11,15 +11,20 @@
 
 #include <cstdint>
 #include <gsaca-double-sort-par.hpp>
+#include <vector>
 
 #include "ds/lce_naive_wordwise_xor.hpp"
 #include "rmq/rmq_n.hpp"
+#include "util/memory_breakdown.hpp"
 
 #ifdef LCE_BENCHMARK_INTERNAL
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include "util/timer.hpp"
+#ifdef LCE_BENCHMARK_PERF
+#include "util/perf_counters.hpp"
+#endif
 #ifdef LCE_BENCHMARK_SPACE
 #include <malloc_count/malloc_count.h>
 #endif
@@ -40,6 +45,9 @@ class lce_classic {
     // sort sa
 #ifdef LCE_BENCHMARK_INTERNAL
     lce::util::timer t;
+#ifdef LCE_BENCHMARK_PERF
+    lce::util::perf_counters perf;
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     size_t mem_before = malloc_count_current();
     malloc_count_reset_peak();
@@ -48,6 +56,9 @@ class lce_classic {
     gsaca_for_lce(text, sa.data(), size);
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" sa_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("sa");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" sa_mem={}", malloc_count_current() - mem_before);
     fmt::print(" sa_mem_peak={}", malloc_count_peak() - mem_before);
@@ -65,6 +76,9 @@ class lce_classic {
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" isa_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("isa");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" isa_mem={}", malloc_count_current() - mem_before);
     fmt::print(" isa_mem_peak={}", malloc_count_peak() - mem_before);
@@ -110,6 +124,9 @@ class lce_classic {
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" lcp_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("lcp");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" lcp_mem={}", malloc_count_current() - mem_before);
     fmt::print(" lcp_mem_peak={}", malloc_count_peak() - mem_before);
@@ -123,6 +140,9 @@ class lce_classic {
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" rmq_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("rmq");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" rmq_mem={}", malloc_count_current() - mem_before);
     fmt::print(" rmq_mem_peak={}", malloc_count_peak() - mem_before);
@@ -171,6 +191,37 @@ class lce_classic {
     return {r + lce != m_size, lce};
   }
 
+  // Return the length of the longest common prefix of text[i..] and text[j..]
+  // with at most k mismatches (kangaroo jumps). If mismatches is not null, the
+  // offsets of the skipped mismatches are appended to it. Each jump first
+  // scans one word, so close mismatches need no rmq.
+  size_t lce_k_mismatch(size_t i, size_t j, size_t k,
+                        std::vector<size_t>* mismatches = nullptr) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+    const size_t l = std::min(i, j);
+    const size_t r = std::max(i, j);
+    const size_t max_lce = m_size - r;
+    size_t ext = 0;
+    for (size_t m = 0;; ++m) {
+      const size_t scan_end = r + std::min<size_t>(ext + 8, max_lce);
+      ext += lce_naive_wordwise_xor<t_char_type>::lce_lr(m_text, scan_end,
+                                                          l + ext, r + ext);
+      if (r + ext == scan_end && ext < max_lce) {
+        ext += lce_lr(l + ext, r + ext);
+      }
+      if (ext == max_lce || m == k) {
+        return ext;
+      }
+      if (mismatches != nullptr) {
+        mismatches->push_back(ext);
+      }
+      ++ext;
+    }
+  }
+
   // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
   // and j must be different.
   bool is_leq_suffix(size_t i, size_t j) {
@@ -181,6 +232,14 @@ class lce_classic {
         ((j + lce_val != m_size) && m_text[i + lce_val] < m_text[j + lce_val]));
   }
 
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem;
+    mem.add("isa", m_isa);
+    mem.add("lcp", m_lcp);
+    mem.add(m_rmq.memory_breakdown());
+    return mem;
+  }
+
  private:
   std::vector<t_index_type> m_isa;
   std::vector<t_index_type> m_lcp;
@@ -14,12 +14,17 @@
 
 #include "ds/lce_naive_wordwise_xor.hpp"
 #include "rmq/rmq_n.hpp"
+#include "util/memory_breakdown.hpp"
+#include "util/query_stats.hpp"
 
 #ifdef LCE_BENCHMARK_INTERNAL
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include "util/timer.hpp"
+#ifdef LCE_BENCHMARK_PERF
+#include "util/perf_counters.hpp"
+#endif
 #ifdef LCE_BENCHMARK_SPACE
 #include <malloc_count/malloc_count.h>
 #endif
@@ -33,14 +38,24 @@ class lce_classic_for_sss {
   lce_classic_for_sss() : m_size{0} {
   }
 
-  lce_classic_for_sss(uint8_t const* text, size_t text_size,
+  // The text is either a uint8_t const* or a util::reversed_text<uint8_t>.
+  // If keep_sa is set, the sparse suffix array (indices into sss) is kept for
+  // sa() instead of being discarded after the LCP array is built. tau must
+  // only be given if t_tau is rolling_hash::dynamic_tau (0).
+  template <typename t_text>
+  lce_classic_for_sss(t_text const& text, size_t text_size,
                       t_index_type const* reduced_fps, size_t reduced_fps_size,
-                      std::vector<t_index_type> const& sss)
+                      std::vector<t_index_type> const& sss,
+                      bool keep_sa = false, uint64_t tau = t_tau)
       : m_size(reduced_fps_size) {
+    assert(tau != 0 && (tau == t_tau || t_tau == 0));
     std::vector<t_index_type> sa(reduced_fps_size);
     // sort sa
 #ifdef LCE_BENCHMARK_INTERNAL
     lce::util::timer t;
+#ifdef LCE_BENCHMARK_PERF
+    lce::util::perf_counters perf;
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     size_t mem_before = malloc_count_current();
     malloc_count_reset_peak();
@@ -50,6 +65,9 @@ class lce_classic_for_sss {
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" sa_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("sa");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" sa_mem={}", malloc_count_current() - mem_before);
     fmt::print(" sa_mem_peak={}", malloc_count_peak() - mem_before);
@@ -67,6 +85,9 @@ class lce_classic_for_sss {
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" isa_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("isa");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" isa_mem={}", malloc_count_current() - mem_before);
     fmt::print(" isa_mem_peak={}", malloc_count_peak() - mem_before);
@@ -107,7 +128,7 @@ class lce_classic_for_sss {
                current_lcp);
 
         uint64_t diff = sss[i + 1] - sss[i];
-        if (current_lcp < 2 * t_tau + diff) {
+        if (current_lcp < 2 * tau + diff) {
           current_lcp = 0;
         } else {
           current_lcp -= diff;
@@ -117,6 +138,9 @@ class lce_classic_for_sss {
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" lcp_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("lcp");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" lcp_mem={}", malloc_count_current() - mem_before);
     fmt::print(" lcp_mem_peak={}", malloc_count_peak() - mem_before);
@@ -127,9 +151,15 @@ class lce_classic_for_sss {
 
     // build rmq
     m_rmq = lce::rmq::rmq_n<t_index_type>(m_lcp);
+    if (keep_sa) {
+      m_sa = std::move(sa);
+    }
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" rmq_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("rmq");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" rmq_mem={}", malloc_count_current() - mem_before);
     fmt::print(" rmq_mem_peak={}", malloc_count_peak() - mem_before);
@@ -147,11 +177,46 @@ class lce_classic_for_sss {
   // Return the number of common letters in text[i..] and text[j..].
   // Here l must be smaller than r.
   size_t lce_lr(size_t l, size_t r) const {
+    util::query_stats::count_rmq();
     return m_lcp[m_rmq.rmq_shifted(m_isa[l], m_isa[r])];
   }
 
+  // The number of synchronizing positions.
+  size_t size() const {
+    return m_size;
+  }
+
+  // The synchronizing positions (as indices into sss) in the lexicographic
+  // order of their suffixes. It is empty unless the structure was built with
+  // keep_sa.
+  std::vector<t_index_type> const& sa() const {
+    return m_sa;
+  }
+
+  std::vector<t_index_type> const& isa() const {
+    return m_isa;
+  }
+
+  // lcp()[k] is the number of common letters (in the text) of the suffixes
+  // at sa()[k - 1] and sa()[k], lcp()[0] = 0.
+  std::vector<t_index_type> const& lcp() const {
+    return m_lcp;
+  }
+
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem;
+    if (!m_sa.empty()) {
+      mem.add("sa", m_sa);
+    }
+    mem.add("isa", m_isa);
+    mem.add("lcp", m_lcp);
+    mem.add(m_rmq.memory_breakdown());
+    return mem;
+  }
+
  private:
   size_t m_size;
+  std::vector<t_index_type> m_sa;
   std::vector<t_index_type> m_isa;
   std::vector<t_index_type> m_lcp;
   lce::rmq::rmq_n<t_index_type> m_rmq;
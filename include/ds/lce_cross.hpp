@@ -0,0 +1,307 @@
+/*******************************************************************************
+ * lce/ds/lce_cross.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <parallel_hashmap/phmap.h>
+#include <utility>
+#include <vector>
+
+#include "ds/lce_fp.hpp"
+#include "ds/lce_naive_wordwise_xor.hpp"
+#include "ds/lce_sss.hpp"
+#include "util/memory_breakdown.hpp"
+
+namespace lce::ds {
+
+// The reference text A of cross-text lce queries: an lce_sss on A and its
+// synchronizing positions by the fingerprints of their 3 * tau long prefixes.
+// It is built once and shared by the indexes of any number of other texts
+// (see lce_cross_index), A is never copied or concatenated with them.
+template <typename t_char_type = uint8_t, uint64_t t_tau = 1024,
+          typename t_index_type = uint32_t, bool t_prefer_long = false,
+          typename t_pred_type =
+              lce::pred::pred_index<t_index_type, std::bit_width(t_tau) - 1,
+                                    t_index_type>>
+class lce_cross_reference {
+ public:
+  typedef t_char_type char_type;
+  typedef t_index_type index_type;
+  typedef t_pred_type pred_type;
+  typedef lce_sss<t_char_type, t_tau, t_index_type, t_prefer_long, t_pred_type>
+      ds_type;
+  typedef typename ds_type::sss_type sss_type;
+  __extension__ typedef unsigned __int128 uint128_t;
+  static constexpr uint64_t tau = t_tau;
+
+  lce_cross_reference() : m_text(nullptr), m_size(0) {}
+
+  // The synchronizing set is computed once with fingerprints, which are
+  // dropped before the lce_sss is built on it.
+  lce_cross_reference(char_type const* text, size_t size)
+      : m_text(text), m_size(size) {
+    sss_type sync_set(text, size, true);
+    std::vector<uint128_t> const& fps = sync_set.get_fps();
+    // the last position of a synchronizing set with runs is a sentinel
+    const size_t num = sync_set.size() - (sync_set.has_runs() ? 1 : 0);
+    m_sync_fps.reserve(num);
+    for (size_t k = 0; k < num; ++k) {
+      m_sync_fps.emplace(key(fps[k]), sync_set[k]);
+    }
+    sync_set.free_fps();
+    m_ds = ds_type(text, size, std::move(sync_set));
+  }
+
+  template <typename C>
+  lce_cross_reference(C const& container)
+      : lce_cross_reference(container.data(), container.size()) {}
+
+  // Return the number of common letters in text[i..] and text[j..].
+  size_t lce(size_t i, size_t j) const {
+    return m_ds.lce(i, j);
+  }
+
+  // Return a synchronizing position whose 3 * tau long prefix has the
+  // fingerprint fp, or size() if there is none.
+  size_t find(uint128_t fp) const {
+    const auto it = m_sync_fps.find(key(fp));
+    return it == m_sync_fps.end() ? m_size : size_t{it->second};
+  }
+
+  // The fingerprints of positions that start a run carry its length in the
+  // bits above the 107 bit prime, which depends on the text.
+  static uint64_t key(uint128_t fp) {
+    fp &= (uint128_t{1} << 107) - 1;
+    return uint64_t(fp) ^ uint64_t(fp >> 64);
+  }
+
+  ds_type const& ds() const {
+    return m_ds;
+  }
+
+  char_type const* text() const {
+    return m_text;
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+  // Bytes per component, the fingerprint map is estimated from its slots.
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem = m_ds.memory_breakdown();
+    mem.add("sync_fps",
+            m_sync_fps.capacity() *
+                (sizeof(typename decltype(m_sync_fps)::value_type) + 1));
+    return mem;
+  }
+
+ private:
+  char_type const* m_text;
+  size_t m_size;
+  ds_type m_ds;
+  phmap::flat_hash_map<uint64_t, t_index_type> m_sync_fps;
+};
+
+// A light index on a text B for lce queries between B and a reference text A.
+// It only has the synchronizing set of B (with the same tau and rolling hash
+// base as A), its successor structure and an anchor per synchronizing
+// position y: a position z of A and the lce m of A[z..] and B[y..]. The anchor
+// is a synchronizing position of A with the same 3 * tau long prefix, or it is
+// inherited from the previous anchor if that one reaches past y.
+//
+// A query lce(i, j) scans to the successor y of j in B and continues at
+// x = i + (y - j) with the anchor (z, m) of y: if a = lce_A(x, z) differs from
+// m, the answer ends after min(a, m) more letters. Otherwise A[x + m] and
+// B[y + m] are compared and the query continues after them. Without anchor it
+// continues at the next synchronizing position. The result is always exact,
+// the fingerprints only decide how far a query gets with one lce_A query.
+template <typename t_reference_type>
+class lce_cross_index {
+ public:
+  typedef t_reference_type reference_type;
+  typedef typename reference_type::char_type char_type;
+  typedef typename reference_type::index_type index_type;
+  typedef typename reference_type::sss_type sss_type;
+  typedef typename reference_type::pred_type pred_type;
+
+  lce_cross_index() : m_reference(nullptr), m_text(nullptr), m_size(0) {}
+
+  lce_cross_index(reference_type const& reference, char_type const* text,
+                  size_t size)
+      : m_reference(&reference), m_text(text), m_size(size) {
+    m_sync_set = sss_type(text, size, true);
+    m_pred = pred_type(m_sync_set.get_sss());
+    build_anchors();
+    m_sync_set.free_fps();
+  }
+
+  template <typename C>
+  lce_cross_index(reference_type const& reference, C const& container)
+      : lce_cross_index(reference, container.data(), container.size()) {}
+
+  // the successor structure points into the synchronizing set, which keeps its
+  // buffer when it is moved
+  lce_cross_index(lce_cross_index const& other) = delete;
+  lce_cross_index& operator=(lce_cross_index const& other) = delete;
+  lce_cross_index(lce_cross_index&& other) = default;
+  lce_cross_index& operator=(lce_cross_index&& other) = default;
+
+  // Return the number of common letters in A[i..] and B[j..].
+  size_t lce(size_t i, size_t j) const {
+    const size_t a_size = m_reference->size();
+    assert(i < a_size && j < m_size);
+    char_type const* const a = m_reference->text();
+    const size_t max_lce = std::min(a_size - i, m_size - j);
+    size_t ext = 0;
+    while (true) {
+      // Naive part until the next synchronizing position of B
+      const pred::result res = m_pred.successor(j + ext);
+      const size_t sync_ext =
+          res.exists ? std::min<size_t>(m_sync_set[res.pos] - j, max_lce)
+                     : max_lce;
+      ext += lce_naive_wordwise_xor<char_type>::lce_cross(
+          a + i + ext, m_text + j + ext, sync_ext - ext);
+      if (ext < sync_ext || ext == max_lce) {
+        return ext;
+      }
+
+      const size_t anchor_lce = m_anchor_lce[res.pos];
+      if (anchor_lce != 0) {
+        const size_t x = i + ext;
+        const size_t z = m_anchor[res.pos];
+        const size_t a_lce = m_reference->lce(x, z);
+        if (a_lce != anchor_lce) {
+          return ext + std::min(a_lce, anchor_lce);
+        }
+        ext += anchor_lce;
+        if (ext == max_lce) {
+          return ext;
+        }
+      }
+      // A[x..] and B[y..] differ from the anchor at the same offset (or
+      // there is no anchor), so they have to be compared there
+      if (a[i + ext] != m_text[j + ext]) {
+        return ext;
+      }
+      if (++ext == max_lce) {
+        return ext;
+      }
+    }
+  }
+
+  reference_type const& reference() const {
+    return *m_reference;
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+  // The fraction of synchronizing positions of B with an anchor in A.
+  double anchored() const {
+    const size_t anchors = std::count_if(m_anchor_lce.begin(),
+                                         m_anchor_lce.end(),
+                                         [](index_type m) { return m != 0; });
+    return m_anchor_lce.empty() ? 0.0 : double(anchors) / m_anchor_lce.size();
+  }
+
+  // Bytes per component, the reference is not included.
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem = m_sync_set.memory_breakdown();
+    if constexpr (requires { m_pred.memory_breakdown(); }) {
+      mem.add(m_pred.memory_breakdown());
+    } else if constexpr (requires { m_pred.size_in_bytes(); }) {
+      mem.add("pred", m_pred.size_in_bytes());
+    }
+    mem.add("anchor", m_anchor);
+    mem.add("anchor_lce", m_anchor_lce);
+    return mem;
+  }
+
+ private:
+  reference_type const* m_reference;
+  char_type const* m_text;
+  size_t m_size;
+  sss_type m_sync_set;
+  pred_type m_pred;
+  std::vector<index_type> m_anchor;
+  // 0 if the synchronizing position has no anchor
+  std::vector<index_type> m_anchor_lce;
+
+  // Each thread anchors a slice of the synchronizing set. An anchor (z, m) of
+  // y covers the next synchronizing position y' < y + m with (z + y' - y,
+  // m - y' + y), so long common substrings of A and B are only scanned once.
+  void build_anchors() {
+    const size_t num = m_sync_set.size();
+    std::vector<index_type> const& sss = m_sync_set.get_sss();
+    std::vector<typename sss_type::uint128_t> const& fps =
+        m_sync_set.get_fps();
+    char_type const* const a = m_reference->text();
+    const size_t a_size = m_reference->size();
+    m_anchor.resize(num);
+    m_anchor_lce.resize(num);
+
+#pragma omp parallel
+    {
+      const int t = omp_get_thread_num();
+      const int nt = omp_get_num_threads();
+      const size_t slice_size = num / nt;
+      const size_t begin = t * slice_size;
+      const size_t end = (t < nt - 1) ? (t + 1) * slice_size : num;
+
+      size_t prev_y = 0;
+      size_t prev_z = 0;
+      size_t prev_m = 0;
+      for (size_t k = begin; k < end; ++k) {
+        const size_t y = sss[k];
+        size_t z = a_size;
+        size_t m = 0;
+        if (prev_m > y - prev_y) {
+          z = prev_z + (y - prev_y);
+          m = prev_m - (y - prev_y);
+        } else {
+          z = m_reference->find(fps[k]);
+          if (z != a_size) {
+            m = lce_naive_wordwise_xor<char_type>::lce_cross(
+                a + z, m_text + y, std::min(a_size - z, m_size - y));
+          }
+        }
+        if (m != 0) {
+          prev_y = y;
+          prev_z = z;
+          prev_m = m;
+          m_anchor[k] = z;
+        }
+        m_anchor_lce[k] = m;
+      }
+    }
+  }
+};
+
+// Return the number of common letters in A[i..] and B[j..], where b is the
+// index of B on the reference a.
+template <typename t_reference_type>
+size_t lce(t_reference_type const& a, size_t i,
+           lce_cross_index<t_reference_type> const& b, size_t j) {
+  assert(&b.reference() == &a);
+  return b.lce(i, j);
+}
+
+// Return the number of common letters in A[i..] and B[j..] of two lce_fp,
+// which compare their fingerprints directly (see lce_fp::lce).
+template <typename t_char_type, size_t t_naive_scan>
+size_t lce(lce_fp<t_char_type, t_naive_scan> const& a, size_t i,
+           lce_fp<t_char_type, t_naive_scan> const& b, size_t j) {
+  return a.lce(i, b, j);
+}
+}  // namespace lce::ds
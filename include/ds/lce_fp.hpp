@@ -10,11 +10,14 @@
 #include <assert.h>
 #include <omp.h>
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <cstdint>
+#include <vector>
 
 #include "rolling_hash/modular_arithmetic.hpp"
+#include "util/memory_breakdown.hpp"
 
 namespace lce::ds {
 
@@ -38,14 +41,14 @@ class lce_fp {
     // For small endian systems we need to swap the order of bytes in order to
     // calculate fingerprints. Luckily this step is fast.
     if constexpr (std::endian::native == std::endian::little) {
-#pragma omp parallel for
+#pragma omp parallel for if (size_in_blocks >= m_min_parallel_blocks)
       for (size_t i = 0; i < size_in_blocks; ++i) {
         m_block_fps[i] =
             __builtin_bswap64(m_block_fps[i]);  // C++23 std::byteswap!
       }
     }
 
-#pragma omp parallel
+#pragma omp parallel if (size_in_blocks >= m_min_parallel_blocks)
     {
       int t = omp_get_thread_num();
       int nt = omp_get_num_threads();
@@ -77,7 +80,7 @@ class lce_fp {
           (last_block_influence + cur_block_influence) % m_prime;
     }
 
-#pragma omp parallel
+#pragma omp parallel if (size_in_blocks >= m_min_parallel_blocks)
     {
       int t = omp_get_thread_num();
       int nt = omp_get_num_threads();
@@ -111,9 +114,10 @@ class lce_fp {
   // copy constructor
   lce_fp(const lce_fp& other) = delete;
 
-  // move constructor
+  // move constructor, only one of the two may restore the text
   lce_fp(lce_fp&& other)
       : m_block_fps(other.m_block_fps), m_size(other.m_size) {
+    other.m_block_fps = nullptr;
   }
 
   // copy assignment
@@ -121,8 +125,12 @@ class lce_fp {
 
   // move assignment
   lce_fp& operator=(lce_fp&& other) noexcept {
-    m_block_fps = other.m_block_fps;
-    m_size = other.m_size;
+    if (this != &other) {
+      retransform_text();
+      m_block_fps = other.m_block_fps;
+      m_size = other.m_size;
+      other.m_block_fps = nullptr;
+    }
     return *this;
   }
 
@@ -171,34 +179,143 @@ class lce_fp {
     if (lce < t_naive_scan) {
       return lce;
     }
+    return lce_search(l, r, max_lce);
+  }
+
+  // Return the number of common letters in text[i..] and the text of other at
+  // j. The fingerprints of all lce_fp use the same prime and base, so other
+  // can be built on a second text without concatenating the two.
+  size_t lce(size_t i, lce_fp const& other, size_t j) const {
+    assert(i < m_size && j < other.m_size);
+    return lce(i, other, j, std::min(m_size - i, other.m_size - j));
+  }
+
+  // The same, but at most max_lce letters are compared.
+  size_t lce(size_t i, lce_fp const& other, size_t j, uint64_t max_lce) const {
+    if (max_lce == 0) {
+      return 0;
+    }
+    uint64_t lce = lce_scan(i, other, j, max_lce);
+    if (lce < t_naive_scan) {
+      return lce;
+    }
+    return lce_search(i, other, j, max_lce);
+  }
+
+  // The prefix fingerprints of a pattern given at query time, which are
+  // computed once in O(m) for lce queries against the text (see
+  // lce(pattern, offset, i)). The pattern is copied into blocks and
+  // transformed like the text, so the queries use the same scans and
+  // fingerprint search as two text positions.
+  class pattern {
+   public:
+    pattern() : pattern(nullptr, 0) {
+    }
+
+    pattern(char_type const* p, size_t m)
+        : m_size(m), m_blocks(std::max<size_t>(1, (m + 7) / 8), 0) {
+      std::copy(p, p + m, reinterpret_cast<char_type*>(m_blocks.data()));
+      m_fp = lce_fp(reinterpret_cast<char_type*>(m_blocks.data()),
+                    m_blocks.size() * 8);
+    }
+
+    template <typename C>
+    pattern(C const& container) : pattern(container.data(), container.size()) {
+    }
+
+    // The fingerprints point into m_blocks, which keeps its buffer when it is
+    // moved.
+    pattern(pattern const& other) = delete;
+    pattern& operator=(pattern const& other) = delete;
+    pattern(pattern&& other) = default;
+
+    // The old blocks are restored by m_fp before they are freed.
+    pattern& operator=(pattern&& other) noexcept {
+      m_fp = std::move(other.m_fp);
+      m_blocks = std::move(other.m_blocks);
+      m_size = other.m_size;
+      return *this;
+    }
+
+    char_type operator[](size_t i) const {
+      assert(i < m_size);
+      return m_fp[i];
+    }
+
+    size_t size() const {
+      return m_size;
+    }
+
+    // The fingerprints of the pattern padded with zeros to a multiple of 8.
+    lce_fp const& fingerprints() const {
+      return m_fp;
+    }
+
+   private:
+    size_t m_size;
+    std::vector<uint64_t> m_blocks;
+    lce_fp m_fp;
+  };
+
+  // Return the number of common letters in p[offset..] and text[i..].
+  size_t lce(pattern const& p, size_t offset, size_t i) const {
+    assert(offset <= p.size() && i < m_size);
+    return p.fingerprints().lce(offset, *this, i,
+                                std::min(p.size() - offset, m_size - i));
+  }
+
+  // Return the number of common letters in text[l..] and text[r..], which is
+  // at most max_lce, given that the first t_naive_scan letters match.
+  size_t lce_search(size_t l, size_t r, uint64_t max_lce) const {
+    return lce_search(l, *this, r, max_lce);
+  }
+
+  // The same for text[l..] and the text of other at r.
+  size_t lce_search(size_t l, lce_fp const& other, size_t r,
+                    uint64_t max_lce) const {
     // Exponential search
     uint64_t dist = t_naive_scan * 2;
     int exp = std::countr_zero(dist);
 
     const uint128_t fingerprint_to_l = (l != 0) ? fp_to(l - 1) : 0;
-    const uint128_t fingerprint_to_r = (r != 0) ? fp_to(r - 1) : 0;
+    const uint128_t fingerprint_to_r = (r != 0) ? other.fp_to(r - 1) : 0;
 
     while (2 * dist <= max_lce && fp_exp(fingerprint_to_l, l, exp) ==
-                                  fp_exp(fingerprint_to_r, r, exp)) {
+                                  other.fp_exp(fingerprint_to_r, r, exp)) {
       ++exp;
       dist *= 2;
     }
 
+    // If the exponential search stopped at max_lce instead of a mismatch, the
+    // mismatch can be up to 3 * dist / 2 behind the matched part, so the
+    // binary search starts with larger windows that have to fit before
+    // max_lce. Otherwise most of the rest would be left to the scan.
+    const bool at_bound = 2 * dist > max_lce;
+
     // Binary search. We start it at i2 and j2, because we know that up until
     // i2 and j2 everything matched.
     --exp;
     dist /= 2;
     uint64_t add = dist;
+    if (at_bound) {
+      exp += 2;
+      dist *= 4;
+    }
 
     while (dist > t_naive_scan) {
       --exp;
       dist /= 2;
-      if (fp_exp(l + add, exp) == fp_exp(r + add, exp)) {
+      if (add + dist <= max_lce &&
+          fp_exp(l + add, exp) == other.fp_exp(r + add, exp)) {
         add += dist;
       }
     }
+    // the windows may reach max_lce, then there is no block left to scan
+    if (add == max_lce) {
+      return add;
+    }
     max_lce -= add;
-    return add + lce_scan_to_end(l + add, r + add, max_lce);
+    return add + lce_scan_to_end(l + add, other, r + add, max_lce);
   }
 
   // Return {b, lce}, where lce is the number of common letters in text[i..]
@@ -216,6 +333,86 @@ class lce_fp {
     return {r + lce != m_size, lce};
   }
 
+  // Return the length of the longest common prefix of text[i..] and text[j..]
+  // with at most k mismatches (kangaroo jumps). If mismatches is not null, the
+  // offsets of the skipped mismatches are appended to it. The text is scanned
+  // in words and a word can contain several mismatches, so every block is
+  // decoded from the fingerprints only once. After t_naive_scan matching
+  // symbols, the jump continues with the fingerprint search (lce_search).
+  size_t lce_k_mismatch(size_t i, size_t j, size_t k,
+                        std::vector<size_t>* mismatches = nullptr) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+    const size_t l = std::min(i, j);
+    const size_t r = std::max(i, j);
+    const size_t max_lce = m_size - r;
+    // text[l + match_from, l + ext) and text[r + match_from, r + ext) match
+    size_t ext = 0;
+    size_t match_from = 0;
+    size_t m = 0;
+    while (ext < max_lce) {
+      // Compare the words of 8 symbols at l + ext and r + ext, each block is
+      // decoded once.
+      const int offset_l = ((l + ext) % 8) * 8;
+      const int offset_r = ((r + ext) % 8) * 8;
+      size_t block_l = (l + ext) / 8;
+      size_t block_r = (r + ext) / 8;
+      uint64_t cur_l = get_block(block_l);
+      uint64_t next_l = get_block_not_first(block_l + 1);
+      uint64_t cur_r = get_block(block_r);
+      uint64_t next_r = get_block_not_first(block_r + 1);
+      while (true) {
+        const uint64_t word_l =
+            (cur_l << offset_l) + ((next_l >> 1) >> (63 - offset_l));
+        const uint64_t word_r =
+            (cur_r << offset_r) + ((next_r >> 1) >> (63 - offset_r));
+        const size_t len = std::min<size_t>(8, max_lce - ext);
+        uint64_t diff = word_l ^ word_r;
+        if (len < 8) {
+          diff &= ~(~uint64_t{0} >> (8 * len));
+        }
+        while (diff != 0) {
+          const size_t b = std::countl_zero(diff) / 8;
+          if (m == k) {
+            return ext + b;
+          }
+          if (mismatches != nullptr) {
+            mismatches->push_back(ext + b);
+          }
+          ++m;
+          match_from = ext + b + 1;
+          diff &= ~(0xFF00000000000000ULL >> (8 * b));
+        }
+        ext += len;
+        if (ext == max_lce) {
+          return ext;
+        }
+        if (ext - match_from >= t_naive_scan) {
+          break;
+        }
+        cur_l = next_l;
+        next_l = get_block_not_first(++block_l + 1);
+        cur_r = next_r;
+        next_r = get_block_not_first(++block_r + 1);
+      }
+
+      // a long match, continue with the fingerprints
+      ext = match_from + lce_search(l + match_from, r + match_from,
+                                    max_lce - match_from);
+      if (ext == max_lce || m == k) {
+        return ext;
+      }
+      if (mismatches != nullptr) {
+        mismatches->push_back(ext);
+      }
+      ++m;
+      match_from = ++ext;
+    }
+    return max_lce;
+  }
+
   // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
   // and j must be different.
   bool is_leq_suffix(size_t i, size_t j) const {
@@ -230,14 +427,20 @@ class lce_fp {
   // Alternative: Calculate influence, and compare fp - influence until mismatch
   uint64_t lce_scan(const uint64_t i, const uint64_t j,
                     uint64_t max_lce) const {
+    return lce_scan(i, *this, j, max_lce);
+  }
+
+  // The same for text[i..] and the text of other at j.
+  uint64_t lce_scan(const uint64_t i, lce_fp const& other, const uint64_t j,
+                    uint64_t max_lce) const {
     uint64_t lce = 0;
     // Naive part of lce query. Compare blockwise.
     const int offset_lce1 = (i % 8) * 8;
     const int offset_lce2 = (j % 8) * 8;
     uint64_t block_i = get_block(i / 8);
     uint64_t block_i2 = get_block_not_first(i / 8 + 1);
-    uint64_t block_j = get_block(j / 8);
-    uint64_t block_j2 = get_block_not_first(j / 8 + 1);
+    uint64_t block_j = other.get_block(j / 8);
+    uint64_t block_j2 = other.get_block_not_first(j / 8 + 1);
     uint64_t comp_block_i =
         (block_i << offset_lce1) + ((block_i2 >> 1) >> (63 - offset_lce1));
     uint64_t comp_block_j =
@@ -252,7 +455,7 @@ class lce_fp {
       block_i = block_i2;
       block_i2 = get_block_not_first((i / 8) + lce + 1);
       block_j = block_j2;
-      block_j2 = get_block_not_first((j / 8) + lce + 1);
+      block_j2 = other.get_block_not_first((j / 8) + lce + 1);
       comp_block_i =
           (block_i << offset_lce1) + ((block_i2 >> 1) >> (63 - offset_lce1));
       comp_block_j =
@@ -272,20 +475,26 @@ class lce_fp {
 
   uint64_t lce_scan_to_end(const uint64_t i, const uint64_t j,
                            uint64_t max_lce) const {
+    return lce_scan_to_end(i, *this, j, max_lce);
+  }
+
+  uint64_t lce_scan_to_end(const uint64_t i, lce_fp const& other,
+                           const uint64_t j, uint64_t max_lce) const {
     uint64_t lce = 0;
     // Naive part of lce query. Compare blockwise.
     const int offset_lce1 = (i % 8) * 8;
     const int offset_lce2 = (j % 8) * 8;
     uint64_t block_i = get_block(i / 8);
     uint64_t block_i2 = get_block_not_first(i / 8 + 1);
-    uint64_t block_j = get_block(j / 8);
-    uint64_t block_j2 = get_block_not_first(j / 8 + 1);
+    uint64_t block_j = other.get_block(j / 8);
+    uint64_t block_j2 = other.get_block_not_first(j / 8 + 1);
     uint64_t comp_block_i =
         (block_i << offset_lce1) + ((block_i2 >> 1) >> (63 - offset_lce1));
     uint64_t comp_block_j =
         (block_j << offset_lce2) + ((block_j2 >> 1) >> (63 - offset_lce2));
 
-    while (lce < max_lce) {
+    // lce counts blocks, the last partial block is the stub
+    while (lce < max_lce / 8) {
       if (comp_block_i != comp_block_j) {
         break;
       }
@@ -293,7 +502,7 @@ class lce_fp {
       block_i = block_i2;
       block_i2 = get_block_not_first((i / 8) + lce + 1);
       block_j = block_j2;
-      block_j2 = get_block_not_first((j / 8) + lce + 1);
+      block_j2 = other.get_block_not_first((j / 8) + lce + 1);
       comp_block_i =
           (block_i << offset_lce1) + ((block_i2 >> 1) >> (63 - offset_lce1));
       comp_block_j =
@@ -356,10 +565,17 @@ class lce_fp {
     return lce;
   }
 
+  // The fingerprints overwrite the text, so there is nothing besides it.
+  util::memory_breakdown memory_breakdown() const {
+    return {};
+  }
+
  private:
   uint64_t* m_block_fps = nullptr;
   size_t m_size = 0;
   static constexpr uint128_t m_prime{0x800000000000001d};
+  // Smaller texts (e.g. patterns) are transformed by the calling thread.
+  static constexpr size_t m_min_parallel_blocks = 1024;
 
   // Calculates the powers of 2. This supports LCE queries and reduces the time
   // from polylogarithmic to logarithmic.
@@ -378,6 +594,7 @@ class lce_fp {
 
   // Return the i'th block. A block contains 8 character.
   uint64_t get_block(const uint64_t i) const {
+    assert(i < m_size / 8);
     uint128_t x = (i != 0) ? m_block_fps[i - 1] & 0x7FFFFFFFFFFFFFFFULL : 0;
     x <<= 64;
     x %= m_prime;
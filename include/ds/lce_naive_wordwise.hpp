@@ -90,16 +90,20 @@ class lce_naive_wordwise {
     assert(l < r);
     static constexpr size_t blk_size = sizeof(uint64_t) / sizeof(char_type);
     const uint64_t max_lce = size - r;
-    const uint64_t max_blks = max_lce / blk_size;
-    uint64_t const* const blk_i = reinterpret_cast<uint64_t const*>(text + l);
-    uint64_t const* const blk_j = reinterpret_cast<uint64_t const*>(text + r);
     size_t lce_val = 0;
 
-    while (lce_val < max_blks && blk_i[lce_val] == blk_j[lce_val]) {
-      lce_val++;
-    }
+    // letters of at least a word (blk_size = 0) are only compared below
+    if constexpr (blk_size > 0) {
+      const uint64_t max_blks = max_lce / blk_size;
+      uint64_t const* const blk_i = reinterpret_cast<uint64_t const*>(text + l);
+      uint64_t const* const blk_j = reinterpret_cast<uint64_t const*>(text + r);
 
-    lce_val *= blk_size;
+      while (lce_val < max_blks && blk_i[lce_val] == blk_j[lce_val]) {
+        lce_val++;
+      }
+
+      lce_val *= blk_size;
+    }
 
     while (lce_val < max_lce && text[l + lce_val] == text[r + lce_val]) {
       lce_val++;
@@ -9,7 +9,11 @@
 #pragma once
 #include <assert.h>
 
+#include <bit>
 #include <cstdint>
+#include <cstring>
+
+#include "util/reversed_text.hpp"
 
 namespace lce::ds {
 
@@ -88,28 +92,90 @@ class lce_naive_wordwise_xor {
   // Here l must be smaller than r.
   static size_t lce_lr(char_type const* text, size_t size, size_t l, size_t r) {
     assert(l < r);
+    const uint64_t max_lce = size - r;
+    if constexpr (sizeof(char_type) > sizeof(uint64_t)) {
+      // a letter is wider than a word (e.g. the fingerprints in lce_classic
+      // for lce_sss_noss), so blk_size would be 0
+      size_t lce_val = 0;
+      while (lce_val < max_lce && text[l + lce_val] == text[r + lce_val]) {
+        lce_val++;
+      }
+      return lce_val;
+    } else {
+      static constexpr size_t blk_size = sizeof(uint64_t) / sizeof(char_type);
+      const uint64_t max_blks = max_lce / blk_size;
+      uint64_t const* const blk_i = reinterpret_cast<uint64_t const*>(text + l);
+      uint64_t const* const blk_j = reinterpret_cast<uint64_t const*>(text + r);
+      size_t lce_val = 0;
+
+      while (lce_val < max_blks && blk_i[lce_val] == blk_j[lce_val]) {
+        lce_val++;
+      }
+
+      if (lce_val == max_blks) [[unlikely]] {
+        lce_val *= blk_size;
+
+        while (lce_val < max_lce && text[l + lce_val] == text[r + lce_val]) {
+          lce_val++;
+        }
+
+        return lce_val;
+      }
+
+      return lce_val * blk_size +
+             std::countr_zero(blk_i[lce_val] ^ blk_j[lce_val]) /
+                 (8 * sizeof(char_type));
+    }
+  }
+
+  // The same scans on a text read from right to left, view[l..] and view[r..]
+  // are compared with words of the original text ending at its positions
+  // size - 1 - l and size - 1 - r. Here size is the end of the scan.
+  static size_t lce_lr(util::reversed_text<char_type> const& text, size_t size,
+                       size_t l, size_t r) {
+    assert(l < r);
     static constexpr size_t blk_size = sizeof(uint64_t) / sizeof(char_type);
     const uint64_t max_lce = size - r;
     const uint64_t max_blks = max_lce / blk_size;
-    uint64_t const* const blk_i = reinterpret_cast<uint64_t const*>(text + l);
-    uint64_t const* const blk_j = reinterpret_cast<uint64_t const*>(text + r);
+    // the words end at these positions of the original text
+    char_type const* const end_i = text.data() + text.original_pos(l) + 1;
+    char_type const* const end_j = text.data() + text.original_pos(r) + 1;
     size_t lce_val = 0;
-
-    while (lce_val < max_blks && blk_i[lce_val] == blk_j[lce_val]) {
+    uint64_t blk_i;
+    uint64_t blk_j;
+
+    while (lce_val < max_blks) {
+      std::memcpy(&blk_i, end_i - (lce_val + 1) * blk_size, sizeof(uint64_t));
+      std::memcpy(&blk_j, end_j - (lce_val + 1) * blk_size, sizeof(uint64_t));
+      if (blk_i != blk_j) {
+        // the first symbol of the view is the last one of the word
+        return lce_val * blk_size +
+               std::countl_zero(blk_i ^ blk_j) / (8 * sizeof(char_type));
+      }
       lce_val++;
     }
 
-    if (lce_val == max_blks) [[unlikely]] {
-      lce_val *= blk_size;
+    lce_val *= blk_size;
+    while (lce_val < max_lce && text[l + lce_val] == text[r + lce_val]) {
+      lce_val++;
+    }
+    return lce_val;
+  }
 
-      while (lce_val < max_lce && text[l + lce_val] == text[r + lce_val]) {
-        lce_val++;
-      }
+  static size_t lce_uneq(util::reversed_text<char_type> const& text,
+                         size_t size, size_t i, size_t j) {
+    assert(i != j);
+    return lce_lr(text, size, std::min(i, j), std::max(i, j));
+  }
 
-      return lce_val;
+  static size_t lce_up_to(util::reversed_text<char_type> const& text,
+                          size_t size, size_t i, size_t j, size_t up_to) {
+    if (i == j) [[unlikely]] {
+      assert(i < size);
+      return size - i;
     }
-
-    return lce_val * blk_size + std::countr_zero(blk_i[lce_val] ^ blk_j[lce_val]) / (8 * sizeof(char_type));
+    size_t r = std::max(i, j);
+    return lce_lr(text, std::min(r + up_to, size), std::min(i, j), r);
   }
 
   // Return {b, lce}, where lce is the number of common letters in text[i..]
@@ -154,6 +220,33 @@ class lce_naive_wordwise_xor {
     return lce;
   }
 
+  // Return the number of common letters in a[0, max_lce) and b[0, max_lce),
+  // where a and b may point into different texts.
+  static size_t lce_cross(char_type const* a, char_type const* b,
+                          size_t max_lce) {
+    static constexpr size_t blk_size = sizeof(uint64_t) / sizeof(char_type);
+    const uint64_t max_blks = max_lce / blk_size;
+    size_t lce_val = 0;
+    uint64_t blk_a;
+    uint64_t blk_b;
+
+    while (lce_val < max_blks) {
+      std::memcpy(&blk_a, a + lce_val * blk_size, sizeof(uint64_t));
+      std::memcpy(&blk_b, b + lce_val * blk_size, sizeof(uint64_t));
+      if (blk_a != blk_b) {
+        return lce_val * blk_size +
+               std::countr_zero(blk_a ^ blk_b) / (8 * sizeof(char_type));
+      }
+      lce_val++;
+    }
+
+    lce_val *= blk_size;
+    while (lce_val < max_lce && a[lce_val] == b[lce_val]) {
+      lce_val++;
+    }
+    return lce_val;
+  }
+
  private:
   char_type const* m_text;
   size_t m_size;
@@ -11,6 +11,7 @@
 #include <chrono>
 #include <cmath>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "ds/lce_classic_for_sss.hpp"
@@ -18,12 +19,18 @@
 #include "pred/pred_index.hpp"
 #include "rolling_hash/reduce_fingerprints.hpp"
 #include "rolling_hash/string_synchronizing_set.hpp"
+#include "util/memory_breakdown.hpp"
+#include "util/query_stats.hpp"
+#include "util/reversed_text.hpp"
 
 #ifdef LCE_BENCHMARK_INTERNAL
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include "util/timer.hpp"
+#ifdef LCE_BENCHMARK_PERF
+#include "util/perf_counters.hpp"
+#endif
 #ifdef LCE_BENCHMARK_SPACE
 #include <malloc_count/malloc_count.h>
 #endif
@@ -31,72 +38,98 @@
 
 namespace lce::ds {
 
+// t_pred_type is the successor structure over the synchronizing set, it has to
+// be constructible from a std::vector<t_index_type> (see include/pred). If it
+// provides access(i) without keeping a pointer to the data (e.g.
+// elias_fano_index, compressed_sss_index), the synchronizing set is freed after
+// construction and the positions are decoded from the successor structure.
+//
+// t_text_type is how the text is read, either a pointer or a
+// util::reversed_text, which answers the queries on the reversed text without
+// a reversed copy (see lce_sss_bidirectional).
+//
+// If t_tau is rolling_hash::dynamic_tau, tau is passed to the constructor
+// (see lce_sss_dynamic) and the default pred_index takes its low bits from it.
 template <typename t_char_type = uint8_t, uint64_t t_tau = 1024,
-          typename t_index_type = uint32_t, bool t_prefer_long = false>
+          typename t_index_type = uint32_t, bool t_prefer_long = false,
+          typename t_pred_type = lce::pred::pred_index<
+              t_index_type,
+              t_tau == rolling_hash::dynamic_tau ? lce::pred::dynamic_lo_bits
+                                                 : std::bit_width(t_tau) - 1,
+              t_index_type>,
+          typename t_text_type = t_char_type const*>
 class lce_sss {
  public:
   typedef t_char_type char_type;
+  typedef t_text_type text_type;
+  typedef rolling_hash::sss<t_index_type, t_tau> sss_type;
   __extension__ typedef unsigned __int128 uint128_t;
-  lce_sss() : m_text(nullptr), m_size(0) {}
 
-  lce_sss(char_type const* text, size_t size) : m_text(text), m_size(size) {
+  // The successor of a text position among the synchronizing positions (idx
+  // is its index in the synchronizing set, pos its text position). It is also
+  // the successor of every position in [from, pos], so a sequence of queries
+  // that only moves forward (like lce_k_mismatch) can reuse it.
+  struct sync_successor {
+    size_t from = 0;
+    size_t idx = 0;
+    size_t pos = 0;
+    bool exists = false;
+  };
+
+  lce_sss() : m_text(), m_size(0) {}
+
+  // If keep_sa is set, the sparse suffix array of the synchronizing positions
+  // is kept (see sparse_index and sparse_suffix_tree). tau must only be given
+  // if t_tau is rolling_hash::dynamic_tau.
+  lce_sss(text_type text, size_t size, bool keep_sa = false,
+          uint64_t tau = t_tau)
+      : m_text(text), m_size(size) {
     assert(sizeof(t_char_type) == 1);
 
 #ifdef LCE_BENCHMARK_INTERNAL
     lce::util::timer t;
+#ifdef LCE_BENCHMARK_PERF
+    lce::util::perf_counters perf;
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     size_t mem_before = malloc_count_current();
     malloc_count_reset_peak();
 #endif
 #endif
 
-    m_sync_set = rolling_hash::sss<t_index_type, t_tau>(text, size, false);
+    m_sync_set = sss_type(text, size, false, tau);
     // check_string_synchronizing_set(text, m_sync_set);
 
 #ifdef LCE_BENCHMARK_INTERNAL
     fmt::print(" sss_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("sss");
+#endif
     fmt::print(" sss_size={}", m_sync_set.size());
     fmt::print(" sss_runs={}", m_sync_set.num_runs());
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" sss_mem={}", malloc_count_current() - mem_before);
     fmt::print(" sss_mem_peak={}", malloc_count_peak() - mem_before);
-    mem_before = malloc_count_current();
-    malloc_count_reset_peak();
-#endif
-#endif
-
-    m_pred = lce::pred::pred_index<t_index_type, std::bit_width(t_tau) - 1,
-                                   t_index_type>(m_sync_set.get_sss());
-
-#ifdef LCE_BENCHMARK_INTERNAL
-    fmt::print(" pred_time={}", t.get_and_reset());
-#ifdef LCE_BENCHMARK_SPACE
-    fmt::print(" pred_mem={}", malloc_count_current() - mem_before);
-    fmt::print(" pred_mem_peak={}", malloc_count_peak() - mem_before);
-    mem_before = malloc_count_current();
-    malloc_count_reset_peak();
 #endif
 #endif
 
-    std::vector<t_index_type> const& sss = m_sync_set.get_sss();
-    std::vector<t_index_type> reduced_fps = reduce_fps_3tau_lexicographic(
-        reinterpret_cast<uint8_t const*>(m_text), m_size, m_sync_set);
-
-#ifdef LCE_BENCHMARK_INTERNAL
-    fmt::print(" alphabet_reduction_time={}", t.get_and_reset());
-#ifdef LCE_BENCHMARK_SPACE
-    fmt::print(" alphabet_reduction_mem={}", malloc_count_current() - mem_before);
-    fmt::print(" alphabet_reduction_mem_peak={}", malloc_count_peak() - mem_before);
-#endif
-#endif
+    build(keep_sa);
+  }
 
-    m_fp_lce = lce::ds::lce_classic_for_sss<t_index_type, t_tau>(
-        reinterpret_cast<uint8_t const*>(m_text), m_size, reduced_fps.data(),
-        reduced_fps.size(), sss);
+  // Build the index on a synchronizing set of the text computed elsewhere
+  // (e.g. sss_type::mirrored).
+  lce_sss(text_type text, size_t size, sss_type&& sync_set,
+          bool keep_sa = false)
+      : m_text(text), m_size(size) {
+    assert(sizeof(t_char_type) == 1);
+    m_sync_set = std::move(sync_set);
+    build(keep_sa);
   }
 
   template <typename C>
-  lce_sss(C const& container) : lce_sss(container.data(), container.size()) {}
+    requires requires(C const& c) { c.data(); }
+  lce_sss(C const& container, bool keep_sa = false, uint64_t tau = t_tau)
+      : lce_sss(container.data(), container.size(), keep_sa, tau) {}
 
   // Return the number of common letters in text[i..] and text[j..].
   size_t lce(size_t i, size_t j) const {
@@ -107,6 +140,18 @@ class lce_sss {
     return lce_uneq(i, j);
   }
 
+  // Like lce(i, j), but query_case is set to the case of lce_lr that answers
+  // the query (0: mismatch within the first 3*tau symbols, 1: the successors
+  // don't sync, 2: synchronized), or to 0 if i == j.
+  size_t lce_case(size_t i, size_t j, uint64_t& query_case) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      query_case = 0;
+      return m_size - i;
+    }
+    return lce_lr(std::min(i, j), std::max(i, j), &query_case);
+  }
+
   // Return the number of common letters in text[i..] and text[j..]. Here i
   // and j must be different.
   size_t lce_uneq(size_t i, size_t j) const {
@@ -119,57 +164,81 @@ class lce_sss {
   }
 
   // Return the number of common letters in text[i..] and text[j..].
-  // Here l must be smaller than r.
-  inline uint64_t lce_lr(size_t l, size_t r) const {
-    std::vector<t_index_type> const& sss = m_sync_set.get_sss();
+  // Here l must be smaller than r. Unless query_case is null, the case that
+  // answers the query is stored there (see lce_case).
+  inline uint64_t lce_lr(size_t l, size_t r,
+                         uint64_t* query_case = nullptr) const {
+    sync_successor l_succ;
+    sync_successor r_succ;
+    return lce_lr(l, r, l_succ, r_succ, query_case);
+  }
+
+  // Like lce_lr(l, r), but the successors of l and r are taken from l_succ and
+  // r_succ if they are still valid (see find_successor) and stored there.
+  inline uint64_t lce_lr(size_t l, size_t r, sync_successor& l_succ,
+                         sync_successor& r_succ,
+                         uint64_t* query_case = nullptr) const {
     size_t l_, r_;
+    // text positions of the l_-th and r_-th synchronizing position
+    size_t l_sync, r_sync;
 
     if constexpr (t_prefer_long) {
       // Only scan until synchronizing position
       size_t lce_max{m_size - r};
-      size_t lce_local_max{std::min(3 * t_tau, lce_max)};
-
-      pred::result l_res = m_pred.successor(l);
-      pred::result r_res = m_pred.successor(r);
-      l_ = l_res.pos;
-      r_ = r_res.pos;
-      if (l_res.exists && r_res.exists && (sss[l_] - l == sss[r_] - r)) {
-        lce_local_max =
-            std::min(lce_local_max, static_cast<size_t>(sss[l_] - l));
+      size_t lce_local_max{std::min(3 * tau(), lce_max)};
+
+      find_successor(l, l_succ);
+      find_successor(r, r_succ);
+      l_ = l_succ.idx;
+      r_ = r_succ.idx;
+      l_sync = l_succ.pos;
+      r_sync = r_succ.pos;
+      if (l_succ.exists && r_succ.exists && (l_sync - l == r_sync - r)) {
+        lce_local_max = std::min(lce_local_max, l_sync - l);
       }
 
       size_t lce_local = lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
+      util::query_stats::count_scan(lce_local, lce_local_max);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
+        util::query_stats::count_case(0, query_case);
         return lce_local;
       }
     } else {
       // Naive part until synchronizing position
       size_t lce_max{m_size - r};
-      size_t lce_local_max{std::min(3 * t_tau, lce_max)};
+      size_t lce_local_max{std::min(3 * tau(), lce_max)};
       size_t lce_local = lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
+      util::query_stats::count_scan(lce_local, lce_local_max);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
+        util::query_stats::count_case(0, query_case);
         return lce_local;
       }
-      l_ = m_pred.successor(l).pos;
-      r_ = m_pred.successor(r).pos;
+      find_successor(l, l_succ);
+      find_successor(r, r_succ);
+      l_ = l_succ.idx;
+      r_ = r_succ.idx;
+      l_sync = l_succ.pos;
+      r_sync = r_succ.pos;
     }
 
-    if (sss[l_] - l != sss[r_] - r) {
+    if (l_sync - l != r_sync - r) {
       // Case 1: Positions l' and r' don't sync, (because they are at the end of
       // runs).
-      size_t final_lce = std::min(sss[l_] - l, sss[r_] - r) + 2 * t_tau - 1;
+      util::query_stats::count_case(1, query_case);
+      size_t final_lce = std::min(l_sync - l, r_sync - r) + 2 * tau() - 1;
       assert(final_lce == lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
                               m_text, m_size, l, r));
       return final_lce;
     } else {
       // Case 2: Positions l' and r' are synchronized.
-      size_t final_lce = (sss[l_] - l) + m_fp_lce.lce_lr(l_, r_);
+      util::query_stats::count_case(2, query_case);
+      size_t final_lce = (l_sync - l) + m_fp_lce.lce_lr(l_, r_);
       assert(final_lce == lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
                               m_text, m_size, l, r));
       return final_lce;
@@ -191,6 +260,37 @@ class lce_sss {
     return {r + lce != m_size, lce};
   }
 
+  // Return the length of the longest common prefix of text[i..] and text[j..]
+  // with at most k mismatches (kangaroo jumps). If mismatches is not null, the
+  // offsets of the skipped mismatches are appended to it. A jump only queries
+  // the successor structure if it passes the synchronizing positions found by
+  // the previous jumps.
+  size_t lce_k_mismatch(size_t i, size_t j, size_t k,
+                        std::vector<size_t>* mismatches = nullptr) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+    const size_t l = std::min(i, j);
+    const size_t r = std::max(i, j);
+    const size_t max_lce = m_size - r;
+    sync_successor l_succ;
+    sync_successor r_succ;
+    size_t ext = 0;
+    for (size_t m = 0;; ++m) {
+      if (ext < max_lce) {
+        ext += lce_lr(l + ext, r + ext, l_succ, r_succ);
+      }
+      if (ext == max_lce || m == k) {
+        return ext;
+      }
+      if (mismatches != nullptr) {
+        mismatches->push_back(ext);
+      }
+      ++ext;
+    }
+  }
+
   // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
   // and j must be different.
   bool is_leq_suffix(size_t i, size_t j) {
@@ -201,17 +301,154 @@ class lce_sss {
         ((j + lce_val != m_size) && m_text[i + lce_val] < m_text[j + lce_val]));
   }
 
-  char_type operator[](size_t i) { return m_text[i]; }
+  char_type operator[](size_t i) const { return m_text[i]; }
+
+  size_t size() const { return m_size; }
+
+  uint64_t tau() const { return m_sync_set.get_tau(); }
+
+  // The sparse suffix array (if built with keep_sa), its inverse and LCP
+  // array of the synchronizing positions, which are indices k for
+  // sync_position(k).
+  lce::ds::lce_classic_for_sss<t_index_type, t_tau> const& sparse_index()
+      const {
+    return m_fp_lce;
+  }
+
+  // Return the text position of the k-th synchronizing position.
+  size_t sync_position(size_t k) const {
+    return sss_at(k);
+  }
+
+  // Return the successor of text position i among the synchronizing
+  // positions.
+  sync_successor successor(size_t i) const {
+    sync_successor s;
+    find_successor(i, s);
+    return s;
+  }
+
+  // The periodic areas found while building the synchronizing set with runs
+  // (see periodicity.hpp).
+  std::vector<typename sss_type::periodic_region> const& periodic_regions()
+      const {
+    return m_sync_set.periodic_regions();
+  }
 
-  size_t size() { return m_size; }
+  // Bytes per component, the successor structure is reported as "hi_index"
+  // (pred_index) or "pred" if it only provides size_in_bytes().
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem = m_sync_set.memory_breakdown();
+    if constexpr (requires { m_pred.memory_breakdown(); }) {
+      mem.add(m_pred.memory_breakdown());
+    } else if constexpr (requires { m_pred.size_in_bytes(); }) {
+      mem.add("pred", m_pred.size_in_bytes());
+    }
+    mem.add(m_fp_lce.memory_breakdown());
+    return mem;
+  }
 
  private:
-  char_type const* m_text;
+  static constexpr bool pred_has_access =
+      requires(t_pred_type const& pred) { pred.access(size_t{0}); };
+
+  // Build the successor structure, the reduced string and its lce structure
+  // on m_sync_set.
+  void build(bool keep_sa) {
+#ifdef LCE_BENCHMARK_INTERNAL
+    lce::util::timer t;
+#ifdef LCE_BENCHMARK_PERF
+    lce::util::perf_counters perf;
+#endif
+#ifdef LCE_BENCHMARK_SPACE
+    size_t mem_before = malloc_count_current();
+    malloc_count_reset_peak();
+#endif
+#endif
+
+    if constexpr (t_tau == rolling_hash::dynamic_tau &&
+                  std::is_constructible_v<t_pred_type,
+                                          std::vector<t_index_type> const&,
+                                          size_t>) {
+      // the low bits of pred_index follow tau
+      m_pred = t_pred_type(m_sync_set.get_sss(), std::bit_width(tau()) - 1);
+    } else {
+      m_pred = t_pred_type(m_sync_set.get_sss());
+    }
+
+#ifdef LCE_BENCHMARK_INTERNAL
+    fmt::print(" pred_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("pred");
+#endif
+#ifdef LCE_BENCHMARK_SPACE
+    fmt::print(" pred_mem={}", malloc_count_current() - mem_before);
+    fmt::print(" pred_mem_peak={}", malloc_count_peak() - mem_before);
+    mem_before = malloc_count_current();
+    malloc_count_reset_peak();
+#endif
+#endif
+
+    std::vector<t_index_type> const& sss = m_sync_set.get_sss();
+    std::vector<t_index_type> reduced_fps = reduce_fps_3tau_lexicographic(
+        text_bytes(), m_size, m_sync_set);
+
+#ifdef LCE_BENCHMARK_INTERNAL
+    fmt::print(" alphabet_reduction_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("alphabet_reduction");
+#endif
+#ifdef LCE_BENCHMARK_SPACE
+    fmt::print(" alphabet_reduction_mem={}", malloc_count_current() - mem_before);
+    fmt::print(" alphabet_reduction_mem_peak={}", malloc_count_peak() - mem_before);
+#endif
+#endif
+
+    m_fp_lce = lce::ds::lce_classic_for_sss<t_index_type, t_tau>(
+        text_bytes(), m_size, reduced_fps.data(), reduced_fps.size(), sss,
+        keep_sa, tau());
+
+    // the successor structure can answer access queries itself, so we don't
+    // need to keep the uncompressed synchronizing set
+    if constexpr (pred_has_access) {
+      m_sync_set.free_sss();
+    }
+  }
+
+  // The text as bytes for the alphabet reduction and lce_classic_for_sss.
+  auto text_bytes() const {
+    if constexpr (std::is_pointer_v<text_type>) {
+      return reinterpret_cast<uint8_t const*>(m_text);
+    } else {
+      return util::reversed_text<uint8_t>(
+          reinterpret_cast<uint8_t const*>(m_text.data()), m_size);
+    }
+  }
+
+  // Set s to the successor of text position i, unless s already is.
+  inline void find_successor(size_t i, sync_successor& s) const {
+    if (s.exists && s.from <= i && i <= s.pos) {
+      return;
+    }
+    const pred::result res = m_pred.successor(i);
+    util::query_stats::count_pred(1);
+    s = {i, res.pos, sss_at(res.pos), res.exists};
+  }
+
+  // Return the text position of the i-th synchronizing position.
+  inline size_t sss_at(size_t i) const {
+    if constexpr (pred_has_access) {
+      return m_pred.access(i);
+    } else {
+      return m_sync_set[i];
+    }
+  }
+
+  text_type m_text;
   size_t m_size;
 
-  lce::pred::pred_index<t_index_type, std::bit_width(t_tau) - 1, t_index_type>
-      m_pred;
-  rolling_hash::sss<t_index_type, t_tau> m_sync_set;
+  t_pred_type m_pred;
+  sss_type m_sync_set;
   lce::ds::lce_classic_for_sss<t_index_type, t_tau> m_fp_lce;
 };
 }  // namespace lce::ds
\ No newline at end of file
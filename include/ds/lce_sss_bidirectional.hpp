@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * lce/ds/lce_sss_bidirectional.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <utility>
+
+#include "ds/lce_sss.hpp"
+#include "util/memory_breakdown.hpp"
+#include "util/reversed_text.hpp"
+
+namespace lce::ds {
+
+// Lce queries and longest common suffix queries on the same text. The
+// backward index is an lce_sss on the reversed text, but its naive scans and
+// its alphabet reduction read the original buffer from right to left, so there
+// is no reversed copy of the text. If the text has no runs, a synchronizing
+// set of the reversed text is mirrored from the forward one (see
+// sss::mirrored) and the text is only rolled over once.
+template <typename t_char_type = uint8_t, uint64_t t_tau = 1024,
+          typename t_index_type = uint32_t, bool t_prefer_long = false,
+          typename t_pred_type =
+              lce::pred::pred_index<t_index_type, std::bit_width(t_tau) - 1,
+                                    t_index_type>>
+class lce_sss_bidirectional {
+ public:
+  typedef t_char_type char_type;
+  typedef lce_sss<t_char_type, t_tau, t_index_type, t_prefer_long, t_pred_type>
+      forward_type;
+  typedef lce_sss<t_char_type, t_tau, t_index_type, t_prefer_long, t_pred_type,
+                  util::reversed_text<t_char_type>>
+      backward_type;
+  typedef typename forward_type::sss_type sss_type;
+
+  lce_sss_bidirectional() : m_size(0), m_mirrored(false) {}
+
+  lce_sss_bidirectional(char_type const* text, size_t size) : m_size(size) {
+    const util::reversed_text<char_type> reversed(text, size);
+    sss_type sync_set(text, size, false);
+    m_mirrored = !sync_set.has_runs();
+    sss_type backward_sync_set = m_mirrored
+                                     ? sss_type::mirrored(sync_set, size)
+                                     : sss_type(reversed, size, false);
+    m_forward = forward_type(text, size, std::move(sync_set));
+    m_backward = backward_type(reversed, size, std::move(backward_sync_set));
+  }
+
+  template <typename C>
+  lce_sss_bidirectional(C const& container)
+      : lce_sss_bidirectional(container.data(), container.size()) {}
+
+  // Return the number of common letters in text[i..] and text[j..].
+  size_t lce(size_t i, size_t j) const {
+    return m_forward.lce(i, j);
+  }
+
+  // Return the number of common letters in text[..i] and text[..j], i.e. the
+  // length of the longest common suffix of text[0, i] and text[0, j].
+  size_t lcs(size_t i, size_t j) const {
+    assert(i < m_size && j < m_size);
+    return m_backward.lce(m_size - 1 - i, m_size - 1 - j);
+  }
+
+  forward_type const& forward() const {
+    return m_forward;
+  }
+
+  // The index of the reversed text, position i of it is m_size - 1 - i.
+  backward_type const& backward() const {
+    return m_backward;
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+  // Whether the backward synchronizing set was mirrored from the forward one.
+  bool mirrored() const {
+    return m_mirrored;
+  }
+
+  // Bytes per component of both directions.
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem = m_forward.memory_breakdown();
+    mem.add(m_backward.memory_breakdown());
+    return mem;
+  }
+
+  // Return how many bytes two independent lce_sss need more than this, which
+  // is the reversed copy of the text for the backward one.
+  size_t memory_saved() const {
+    return m_size * sizeof(char_type);
+  }
+
+ private:
+  size_t m_size;
+  bool m_mirrored;
+  forward_type m_forward;
+  backward_type m_backward;
+};
+}  // namespace lce::ds
@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * lce/ds/lce_sss_dynamic.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ds/lce_naive_wordwise_xor.hpp"
+#include "ds/lce_sss.hpp"
+#include "util/memory_breakdown.hpp"
+
+namespace lce::ds {
+
+// The estimates of lce_sss_dynamic::auto_tune for one tau.
+struct tau_estimate {
+  uint64_t tau;
+  // synchronizing positions per letter of the sample
+  double density;
+  // fraction of the letters of the sample in periodic areas
+  double run_share;
+  // memory of the index on the whole text, extrapolated from the sample
+  size_t bytes;
+  // mean time of the sampled queries
+  double query_ns;
+};
+
+// The costs of the parts of an lce_sss query. Every query reads the text at
+// two random positions. Queries with lce < 3 * tau only scan, the others scan
+// 3 * tau letters and find the successors of both positions. Unless they are
+// in a run, they also look up the lce of the synchronizing positions (isa and
+// rmq).
+//
+// The defaults are fitted (least squares of the relative error) to the query
+// times of lce_sss with every tau from 64 to 4096 on 16 MiB synthetic texts
+// (dna, uniform, periodic and repetitive, see gen_text). Each sample is a
+// shuffled random mix of their lce ranges (see gen_queries) on one x86 core.
+// The mean error is 27 %, the largest 84 %. The values depend on the machine,
+// benchmark_tau --measure compares them with the measured times.
+struct tau_cost_model {
+  double access_ns = 17;
+  double scan_ns = 0.14;
+  double successor_ns = 3;
+  double rmq_ns = 210;
+};
+
+struct tau_tuning {
+  uint64_t tau;
+  std::vector<tau_estimate> estimates;
+};
+
+// lce_sss with tau chosen at runtime: the synchronizing set, the low bits of
+// pred_index and lce_classic_for_sss take tau from the constructor of
+// lce_sss<..., rolling_hash::dynamic_tau>. Only the scans over the windows
+// while building the synchronizing set are compiled for the common values
+// 256, 512, 1024 and 2048 (see sss::with_tau), any other tau only makes the
+// construction slower. tau is clamped to at least min_tau and less than a
+// fifth of the text (see supported_tau).
+template <typename t_char_type = uint8_t, typename t_index_type = uint32_t,
+          bool t_prefer_long = false>
+class lce_sss_dynamic {
+ public:
+  typedef t_char_type char_type;
+  typedef t_index_type index_type;
+  typedef lce_sss<t_char_type, rolling_hash::dynamic_tau, t_index_type,
+                  t_prefer_long>
+      ds_type;
+
+  // the smallest tau the other lce_sss variants are tested with
+  static constexpr uint64_t min_tau = 16;
+  // the values auto_tune compares
+  static constexpr std::array<uint64_t, 7> taus = {
+      64, 128, 256, 512, 1024, 2048, 4096};
+
+  lce_sss_dynamic() = default;
+
+  // tau is clamped (see supported_tau).
+  lce_sss_dynamic(char_type const* text, size_t size, uint64_t tau)
+      : m_ds(text, size, false, supported_tau(tau, size)) {}
+
+  template <typename C>
+  lce_sss_dynamic(C const& container, uint64_t tau)
+      : lce_sss_dynamic(container.data(), container.size(), tau) {}
+
+  // Return tau if it is at least min_tau and the text is longer than
+  // 5 * tau, otherwise the closest value that is (or min_tau).
+  static uint64_t supported_tau(uint64_t tau, size_t size) {
+    return std::max(min_tau, std::min<uint64_t>(tau, (size - 1) / 5));
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  size_t lce(size_t i, size_t j) const {
+    return m_ds.lce(i, j);
+  }
+
+  // The lce_sss with the chosen tau, e.g. for lce_k_mismatch.
+  ds_type const& ds() const {
+    return m_ds;
+  }
+
+  uint64_t tau() const {
+    return m_ds.tau();
+  }
+
+  char_type operator[](size_t i) const {
+    return m_ds[i];
+  }
+
+  size_t size() const {
+    return m_ds.size();
+  }
+
+  util::memory_breakdown memory_breakdown() const {
+    return m_ds.memory_breakdown();
+  }
+
+  // Choose the tau with the smallest expected query time whose index fits in
+  // memory_budget bytes (or the smallest index if none fits). For each tau an
+  // lce_sss is built on a sample of the text (evenly spaced blocks of
+  // sample_size letters in total), which gives the density of the
+  // synchronizing set, the share of runs and the memory. The query time is
+  // estimated with model from the lce values of the query sample (flattened
+  // pairs), which are computed up to 3 * taus.back().
+  static tau_tuning auto_tune(char_type const* text, size_t size,
+                              std::vector<size_t> const& queries,
+                              size_t memory_budget,
+                              size_t sample_size = size_t{1} << 22,
+                              tau_cost_model const& model = {}) {
+    assert(queries.size() % 2 == 0);
+    const size_t cap = 3 * taus.back();
+    std::vector<size_t> lces(queries.size() / 2);
+#pragma omp parallel for
+    for (size_t q = 0; q < lces.size(); ++q) {
+      const size_t i = queries[2 * q];
+      const size_t j = queries[2 * q + 1];
+      lces[q] = (i == j) ? std::min(cap, size - i)
+                         : lce_naive_wordwise_xor<char_type>::lce_cross(
+                               text + i, text + j,
+                               std::min({cap, size - i, size - j}));
+    }
+
+    const std::vector<char_type> sample = sample_text(text, size, sample_size);
+    tau_tuning result{0, {}};
+    for (uint64_t tau : taus) {
+      estimate(sample, size, lces, model, tau, result.estimates);
+    }
+
+    // the fastest index that fits, ties and indexes that don't fit are
+    // compared by their memory
+    auto better = [&](tau_estimate const& a, tau_estimate const& b) {
+      const bool a_fits = a.bytes <= memory_budget;
+      const bool b_fits = b.bytes <= memory_budget;
+      if (a_fits != b_fits) {
+        return a_fits;
+      }
+      if (a_fits && a.query_ns != b.query_ns) {
+        return a.query_ns < b.query_ns;
+      }
+      return a.bytes < b.bytes;
+    };
+    const auto best = std::min_element(result.estimates.begin(),
+                                       result.estimates.end(), better);
+    result.tau = (best == result.estimates.end()) ? taus.front() : best->tau;
+    return result;
+  }
+
+  template <typename C>
+  static tau_tuning auto_tune(C const& container,
+                              std::vector<size_t> const& queries,
+                              size_t memory_budget,
+                              size_t sample_size = size_t{1} << 22,
+                              tau_cost_model const& model = {}) {
+    return auto_tune(container.data(), container.size(), queries,
+                     memory_budget, sample_size, model);
+  }
+
+ private:
+  ds_type m_ds;
+
+  // The whole text if it is short enough, otherwise 16 evenly spaced blocks.
+  static std::vector<char_type> sample_text(char_type const* text, size_t size,
+                                            size_t sample_size) {
+    if (size <= sample_size) {
+      return std::vector<char_type>(text, text + size);
+    }
+    constexpr size_t num_blocks = 16;
+    const size_t block_size = sample_size / num_blocks;
+    std::vector<char_type> sample;
+    sample.reserve(num_blocks * block_size);
+    for (size_t b = 0; b < num_blocks; ++b) {
+      char_type const* from = text + b * ((size - block_size) / (num_blocks - 1));
+      sample.insert(sample.end(), from, from + block_size);
+    }
+    return sample;
+  }
+
+  static void estimate(std::vector<char_type> const& sample, size_t size,
+                       std::vector<size_t> const& lces,
+                       tau_cost_model const& model, uint64_t tau,
+                       std::vector<tau_estimate>& out) {
+    // the sample must have room for a few synchronizing positions
+    if (sample.size() <= 8 * tau || size <= 5 * tau) {
+      return;
+    }
+    tau_estimate e{tau, 0, 0, 0, 0};
+    {
+      ds_type ds(sample, false, tau);
+      e.density = double(ds.sparse_index().size()) / sample.size();
+      size_t in_runs = 0;
+      for (auto const& r : ds.periodic_regions()) {
+        in_runs += r.end - r.start;
+      }
+      e.run_share = std::min(1.0, double(in_runs) / sample.size());
+      e.bytes = size_t(double(ds.memory_breakdown().total()) / sample.size() *
+                       size);
+    }
+
+    double sum_ns = model.access_ns * lces.size();
+    for (auto l : lces) {
+      if (l < 3 * tau) {
+        sum_ns += model.scan_ns * l;
+      } else {
+        sum_ns += model.scan_ns * 3 * tau + model.successor_ns +
+                  (1 - e.run_share) * model.rmq_ns;
+      }
+    }
+    e.query_ns = lces.empty() ? 0 : sum_ns / lces.size();
+    out.push_back(e);
+  }
+};
+}  // namespace lce::ds
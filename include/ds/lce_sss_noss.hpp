@@ -16,6 +16,8 @@
 #include "ds/lce_naive_wordwise_xor.hpp"
 #include "pred/pred_index.hpp"
 #include "rolling_hash/string_synchronizing_set.hpp"
+#include "util/memory_breakdown.hpp"
+#include "util/query_stats.hpp"
 
 #ifdef LCE_BENCHMARK_INTERNAL
 #include <fmt/core.h>
@@ -96,6 +98,19 @@ class lce_sss_noss {
     return lce_uneq(i, j);
   }
 
+  // Like lce(i, j), but query_case is set to the case of lce_lr that answers
+  // the query (0: mismatch within the first 3*tau symbols, 1: the successors
+  // don't sync, 2: mismatch within 3*tau symbols after the common fingerprints,
+  // 3: mismatch at a run end), or to 0 if i == j.
+  size_t lce_case(size_t i, size_t j, uint64_t& query_case) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      query_case = 0;
+      return m_size - i;
+    }
+    return lce_lr(std::min(i, j), std::max(i, j), &query_case);
+  }
+
   // Return the number of common letters in text[i..] and text[j..]. Here i
   // and j must be different.
   size_t lce_uneq(size_t i, size_t j) const {
@@ -108,8 +123,10 @@ class lce_sss_noss {
   }
 
   // Return the number of common letters in text[i..] and text[j..].
-  // Here l must be smaller than r.
-  inline uint64_t lce_lr(size_t l, size_t r) const {
+  // Here l must be smaller than r. Unless query_case is null, the case that
+  // answers the query is stored there (see lce_case).
+  inline uint64_t lce_lr(size_t l, size_t r,
+                         uint64_t* query_case = nullptr) const {
     std::vector<t_index_type> const& sss = m_sync_set.get_sss();
     size_t l_, r_;
     if constexpr (t_prefer_long) {
@@ -119,6 +136,7 @@ class lce_sss_noss {
 
       pred::result l_res = m_pred.successor(l);
       pred::result r_res = m_pred.successor(r);
+      util::query_stats::count_pred(2);
       l_ = l_res.pos;
       r_ = r_res.pos;
       if (l_res.exists && r_res.exists && (sss[l_] - l == sss[r_] - r)) {
@@ -128,9 +146,11 @@ class lce_sss_noss {
 
       size_t lce_local = lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
+      util::query_stats::count_scan(lce_local, lce_local_max);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
+        util::query_stats::count_case(0, query_case);
         return lce_local;
       }
     } else {
@@ -139,18 +159,22 @@ class lce_sss_noss {
       size_t lce_local_max{std::min(3 * t_tau, lce_max)};
       size_t lce_local = lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
+      util::query_stats::count_scan(lce_local, lce_local_max);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
+        util::query_stats::count_case(0, query_case);
         return lce_local;
       }
       l_ = m_pred.successor(l).pos;
       r_ = m_pred.successor(r).pos;
+      util::query_stats::count_pred(2);
     }
 
     // Case 1: Positions l' and r' don't sync, (because they are at the end of
     // runs).
     if (sss[l_] - l != sss[r_] - r) {
+      util::query_stats::count_case(1, query_case);
       size_t final_lce = std::min(sss[l_] - l, sss[r_] - r) + 2 * t_tau - 1;
       assert(final_lce == lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
                               m_text, m_size, l, r));
@@ -169,7 +193,9 @@ class lce_sss_noss {
       size_t lce_local_max{std::min(3 * t_tau, lce_max)};
       size_t lce_local = lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
           m_text, sss[r__] + lce_local_max, sss[l__], sss[r__]);
+      util::query_stats::count_scan(lce_local, lce_local_max);
       if (lce_local < lce_local_max || lce_local == lce_max) {
+        util::query_stats::count_case(2, query_case);
         size_t final_lce = (sss[l__] - l) + lce_local;
         assert(final_lce == lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
                                 m_text, m_size, l, r));
@@ -178,6 +204,7 @@ class lce_sss_noss {
     }
     // Case 3: Mismatch at run end.
     assert(r__ + 1 < sss.size() - 1);
+    util::query_stats::count_case(3, query_case);
     size_t final_lce =
         std::min(sss[l__ + 1] - l, sss[r__ + 1] - r) + 2 * t_tau - 1;
     assert(final_lce == lce::ds::lce_naive_wordwise_xor<t_char_type>::lce_lr(
@@ -214,6 +241,13 @@ class lce_sss_noss {
 
   size_t size() { return m_size; }
 
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem = m_sync_set.memory_breakdown();
+    mem.add(m_pred.memory_breakdown());
+    mem.add(m_fp_lce.memory_breakdown());
+    return mem;
+  }
+
  private:
  private:
   char_type const* m_text;
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * lce/ds/periodicity.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace lce::ds {
+
+// Return whether p > 0 is a period of text[i, i + len), i.e. text[x] =
+// text[x + p] for all x in [i, i + len - p), with one lce query.
+template <typename ds_type>
+bool is_periodic(ds_type const& ds, size_t i, size_t len, size_t p) {
+  assert(p != 0);
+  return p >= len || ds.lce(i, i + p) >= len - p;
+}
+
+namespace periodicity {
+
+// Return the period of the periodic area (see sss::periodic_region) that
+// contains i if it is shorter than len, otherwise 0.
+template <typename region_type>
+size_t region_period(std::vector<region_type> const& regions, size_t i,
+                     size_t len) {
+  auto it = std::upper_bound(
+      regions.begin(), regions.end(), i,
+      [](size_t x, region_type const& r) { return x < size_t(r.start); });
+  if (it == regions.begin()) {
+    return 0;
+  }
+  --it;
+  const size_t period = it->period;
+  return (i < size_t(it->end) && period < len) ? period : 0;
+}
+
+// Test the candidates p, p + 1, ... <= max_period. If p is no period and
+// l = lce(i, i + p), then no q <= l is a period either: text[i, i + p + l) has
+// the periods p and q, so gcd(p, q) is a period of it (Fine and Wilf) and
+// thus p of text[i, i + len). The candidates up to l are skipped without
+// making p depend on l, so the next lce query does not wait for this one.
+//
+// Most candidates of an aperiodic substring already fail at the first letter,
+// which is cheaper to compare than an lce query. On small alphabets (e.g. dna)
+// whether it matches is hard to predict, so the first letters of 64
+// candidates are compared into a mask without branches and only the
+// candidates in the mask are queried.
+template <typename ds_type>
+size_t test_candidates(ds_type const& ds, size_t i, size_t len, size_t p,
+                       size_t max_period) {
+  size_t ruled_out = 0;
+  auto is_period = [&](size_t q) {
+    if (q <= ruled_out) {
+      return false;
+    }
+    const size_t l = ds.lce(i, i + q);
+    if (l >= len - q) {
+      return true;
+    }
+    ruled_out = l;
+    return false;
+  };
+  const size_t end = (max_period < len) ? max_period + 1 : len;
+  if constexpr (requires { ds[i]; }) {
+    const auto first = ds[i];
+    for (; p < end; p += 64) {
+      const size_t num = std::min<size_t>(64, end - p);
+      uint64_t mask = 0;
+      for (size_t k = 0; k < num; ++k) {
+        mask |= uint64_t{ds[i + p + k] == first} << k;
+      }
+      for (; mask != 0; mask &= mask - 1) {
+        const size_t q = p + std::countr_zero(mask);
+        if (is_period(q)) {
+          return q;
+        }
+      }
+    }
+  } else {
+    for (; p < end; ++p) {
+      if (is_period(p)) {
+        return p;
+      }
+    }
+  }
+  // the whole substring is always a period
+  return (len <= max_period) ? len : 0;
+}
+}  // namespace periodicity
+
+// Return the smallest period of text[i, i + len) if it is at most max_period,
+// otherwise 0. The candidates are tested in increasing order with one lce
+// query each, skipping those that an earlier lce rules out.
+//
+// If ds has periodic areas (lce_sss on a text with runs), the period pi of
+// the area that contains i is tested first. If it is a period and
+// len >= 2 * pi, the smallest period divides pi (Fine and Wilf), so only the
+// divisors of pi are tested. Otherwise its lce rules out the candidates below
+// it.
+template <typename ds_type>
+size_t smallest_period(
+    ds_type const& ds, size_t i, size_t len,
+    size_t max_period = std::numeric_limits<size_t>::max()) {
+  max_period = std::min(max_period, len);
+  if (len <= 1) {
+    return len;
+  }
+  size_t p = 1;
+  if constexpr (requires { ds.periodic_regions(); }) {
+    const size_t pi = periodicity::region_period(ds.periodic_regions(), i, len);
+    if (pi != 0) {
+      const size_t l = ds.lce(i, i + pi);
+      if (l >= len - pi && 2 * pi <= len) {
+        for (size_t d = 1; d <= std::min(pi, max_period); ++d) {
+          if (pi % d == 0 && (d == pi || is_periodic(ds, i, len, d))) {
+            return d;
+          }
+        }
+        return 0;
+      }
+      if (l < len - pi) {
+        p = l + 1;
+      }
+    }
+  }
+  return periodicity::test_candidates(ds, i, len, p, max_period);
+}
+}  // namespace lce::ds
@@ -0,0 +1,292 @@
+/*******************************************************************************
+ * lce/ds/runs.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <ips4o.hpp>
+#include <utility>
+#include <vector>
+
+#include "ds/sparse_suffix_sort.hpp"
+
+#ifdef LCE_BENCHMARK_INTERNAL
+#include <fmt/core.h>
+
+#include "util/timer.hpp"
+#endif
+
+namespace lce::ds {
+
+// The run text[start, start + length) with smallest period period, i.e. a
+// maximal repetition with length >= 2 * period.
+struct run {
+  uint64_t start;
+  uint64_t period;
+  uint64_t length;
+
+  auto operator<=>(run const&) const = default;
+};
+
+namespace runs {
+
+// Lce queries with ds_type on the text and lcs queries with a second instance
+// on a reversed copy of it, for data structures without lcs queries (unlike
+// lce_sss_bidirectional, which needs no copy).
+template <typename ds_type>
+class with_reversed_copy {
+ public:
+  typedef typename ds_type::char_type char_type;
+
+  template <typename C>
+  with_reversed_copy(C& text)
+      : m_reversed(text.rbegin(), text.rend()),
+        m_size(text.size()),
+        m_forward(text),
+        m_backward(m_reversed) {}
+
+  size_t lce(size_t i, size_t j) const {
+    return m_forward.lce(i, j);
+  }
+
+  // Return the number of common letters in text[..i] and text[..j].
+  size_t lcs(size_t i, size_t j) const {
+    return m_backward.lce(m_size - 1 - i, m_size - 1 - j);
+  }
+
+  char_type operator[](size_t i) const {
+    return m_forward[i];
+  }
+
+  // lce_fp transforms the text (see sparse_sort::transforms_text).
+  void retransform_text()
+    requires sparse_sort::transforms_text<ds_type>
+  {
+    m_forward.retransform_text();
+  }
+
+ private:
+  std::vector<char_type> m_reversed;
+  size_t m_size;
+  ds_type m_forward;
+  ds_type m_backward;
+};
+
+// The candidate roots are extended in groups of this size, first all lce
+// queries of the group and then all lcs queries.
+static constexpr size_t group_size = 1024;
+
+// Return whether text[j..] > text[i..] for i < j, in the order of the
+// symbols or in the reversed order. In both orders a proper prefix of a
+// suffix is smaller.
+template <bool t_reversed_order, typename access_type>
+bool is_greater(access_type const& access, size_t i, size_t j) {
+  const size_t l = access.lce_from(i, j, 0);
+  if (j + l == access.size()) {
+    return false;
+  }
+  return t_reversed_order ? access[j + l] < access[i + l]
+                          : access[j + l] > access[i + l];
+}
+
+// Return the Lyndon array, i.e. the length of the longest Lyndon word starting
+// at each position, which ends at the next smaller suffix. The next smaller
+// suffix of i is found by following the chain i + 1, next smaller suffix of
+// i + 1, ... while the suffixes are larger than text[i..]. Each thread
+// computes the chains of its slice. Chains that leave the slice are resolved
+// afterwards from right to left, which are few unless the slice is sorted.
+template <bool t_reversed_order, typename index_type, typename access_type>
+std::vector<index_type> lyndon_array(access_type const& access) {
+  const size_t n = access.size();
+  std::vector<index_type> lyndon(n);
+  // the positions whose chain left the slice and the last position of the
+  // chain in the slice
+  std::vector<std::vector<std::pair<size_t, size_t>>> open(
+      omp_get_max_threads());
+
+#pragma omp parallel
+  {
+    const int t = omp_get_thread_num();
+    const int nt = omp_get_num_threads();
+    const size_t slice_size = n / nt;
+    const size_t begin = t * slice_size;
+    const size_t end = (t < nt - 1) ? (t + 1) * slice_size : n;
+
+    for (size_t i = end; i-- > begin;) {
+      size_t j = i + 1;
+      size_t last = i;
+      while (j < end && is_greater<t_reversed_order>(access, i, j)) {
+        last = j;
+        j += lyndon[j];
+      }
+      lyndon[i] = j - i;
+      if (j == end && end != n) {
+        open[t].emplace_back(i, last);
+      }
+    }
+  }
+
+  // the chain of i continues after last, whose chain is already resolved
+  for (size_t t = open.size(); t-- > 0;) {
+    for (auto const& [i, last] : open[t]) {
+      size_t j = (last == i) ? i + 1 : last + lyndon[last];
+      while (j < n && is_greater<t_reversed_order>(access, i, j)) {
+        j += lyndon[j];
+      }
+      lyndon[i] = j - i;
+    }
+  }
+  return lyndon;
+}
+
+// Extend the longest Lyndon words to runs and append them to out. A run is
+// only reported from its first Lyndon root, i.e. if it doesn't extend a whole
+// period to the left.
+template <typename ds_type, typename index_type>
+void extend_lyndon_roots(ds_type const& ds,
+                         std::vector<index_type> const& lyndon,
+                         std::vector<run>& out) {
+  const size_t n = lyndon.size();
+  std::vector<std::vector<run>> found(omp_get_max_threads());
+
+#pragma omp parallel
+  {
+    const int t = omp_get_thread_num();
+    std::array<size_t, group_size> forward;
+#pragma omp for schedule(dynamic)
+    for (size_t g = 0; g < n; g += group_size) {
+      const size_t g_end = std::min(g + group_size, n);
+      for (size_t i = g; i < g_end; ++i) {
+        const size_t j = i + lyndon[i];
+        forward[i - g] = (j < n) ? ds.lce(i, j) : 0;
+      }
+      for (size_t i = g; i < g_end; ++i) {
+        const size_t period = lyndon[i];
+        const size_t j = i + period;
+        if (j >= n) {
+          continue;
+        }
+        const size_t backward = (i == 0) ? 0 : ds.lcs(i - 1, j - 1);
+        if (backward >= period || forward[i - g] + backward < period) {
+          continue;
+        }
+        found[t].push_back(
+            {i - backward, period, j + forward[i - g] - (i - backward)});
+      }
+    }
+  }
+
+  for (auto& f : found) {
+    out.insert(out.end(), f.begin(), f.end());
+  }
+}
+}  // namespace runs
+
+// Return all runs of text[0, size) sorted by start and period. ds has to
+// answer lce(i, j) and lcs(i, j), the number of common letters in text[..i]
+// and text[..j], thread safe, e.g. lce_sss_bidirectional or
+// runs::with_reversed_copy.
+//
+// Every run has a Lyndon root that is the longest Lyndon word starting at its
+// position in one of the two orders of the alphabet (Bannai et al., The
+// "Runs" Theorem), so the runs are found by extending the longest Lyndon
+// words with one lce and one lcs query each.
+template <typename index_type = uint32_t, typename ds_type, typename char_type>
+std::vector<run> compute_runs(ds_type& ds, char_type const* text,
+                              size_t size) {
+  const sparse_sort::suffix_access<ds_type, char_type> access(ds, text, size);
+  std::vector<run> result;
+
+#ifdef LCE_BENCHMARK_INTERNAL
+  lce::util::timer t;
+#endif
+  {
+    const auto lyndon = runs::lyndon_array<false, index_type>(access);
+#ifdef LCE_BENCHMARK_INTERNAL
+    fmt::print(" lyndon_time={}", t.get_and_reset());
+#endif
+    runs::extend_lyndon_roots(ds, lyndon, result);
+#ifdef LCE_BENCHMARK_INTERNAL
+    fmt::print(" extend_time={}", t.get_and_reset());
+#endif
+  }
+  {
+    const auto lyndon = runs::lyndon_array<true, index_type>(access);
+#ifdef LCE_BENCHMARK_INTERNAL
+    fmt::print(" lyndon_reversed_time={}", t.get_and_reset());
+#endif
+    runs::extend_lyndon_roots(ds, lyndon, result);
+#ifdef LCE_BENCHMARK_INTERNAL
+    fmt::print(" extend_reversed_time={}", t.get_and_reset());
+#endif
+  }
+
+  // runs that end at the end of the text or whose roots are Lyndon words in
+  // both orders are found twice
+  ips4o::parallel::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+template <typename index_type = uint32_t, typename ds_type, typename C>
+std::vector<run> compute_runs(ds_type& ds, C const& text) {
+  return compute_runs<index_type>(ds, text.data(), text.size());
+}
+
+// Encode runs sorted by start as varints (7 bits per byte, the highest bit
+// tells whether another byte follows): the distance to the start of the
+// previous run, the period and the length minus twice the period.
+inline std::vector<uint8_t> encode_runs(std::vector<run> const& runs) {
+  std::vector<uint8_t> bytes;
+  auto put = [&](uint64_t x) {
+    while (x >= 0x80) {
+      bytes.push_back(uint8_t(x) | 0x80);
+      x >>= 7;
+    }
+    bytes.push_back(uint8_t(x));
+  };
+  uint64_t prev_start = 0;
+  for (auto const& r : runs) {
+    assert(r.start >= prev_start && r.length >= 2 * r.period);
+    put(r.start - prev_start);
+    put(r.period);
+    put(r.length - 2 * r.period);
+    prev_start = r.start;
+  }
+  return bytes;
+}
+
+inline std::vector<run> decode_runs(std::vector<uint8_t> const& bytes) {
+  std::vector<run> runs;
+  size_t pos = 0;
+  auto get = [&]() {
+    uint64_t x = 0;
+    for (size_t shift = 0; pos < bytes.size(); shift += 7) {
+      const uint8_t b = bytes[pos++];
+      x |= uint64_t(b & 0x7F) << shift;
+      if (b < 0x80) {
+        break;
+      }
+    }
+    return x;
+  };
+  uint64_t start = 0;
+  while (pos < bytes.size()) {
+    start += get();
+    const uint64_t period = get();
+    runs.push_back({start, period, get() + 2 * period});
+  }
+  return runs;
+}
+}  // namespace lce::ds
@@ -0,0 +1,356 @@
+/*******************************************************************************
+ * lce/ds/sparse_suffix_sort.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <ips4o.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lce::ds {
+
+namespace sparse_sort {
+
+// Groups of suffixes with the same first 8 symbols of at most this size are
+// sorted by an lcp-aware merge sort by a single thread, larger groups are
+// split into chunks of this size (see lcp_merge_sort_parallel).
+static constexpr size_t merge_threshold = 1 << 14;
+
+// lce_fp transforms the text in place, so its symbols are read with ds[i].
+template <typename ds_type>
+constexpr bool transforms_text =
+    requires(ds_type& ds) { ds.retransform_text(); };
+
+template <typename ds_type, typename char_type>
+class suffix_access {
+ public:
+  suffix_access(ds_type& ds, char_type const* text, size_t size)
+      : m_ds(ds), m_text(text), m_size(size) {}
+
+  char_type operator[](size_t i) const {
+    if constexpr (transforms_text<ds_type>) {
+      return m_ds[i];
+    } else {
+      return m_text[i];
+    }
+  }
+
+  // Return the first 8 symbols of text[i..] as a big endian word, padded with
+  // zeros, such that key(i) < key(j) implies text[i..] < text[j..].
+  uint64_t key(size_t i) const {
+    static_assert(sizeof(char_type) == 1);
+    static constexpr uint64_t sign_flip =
+        std::is_signed_v<char_type> ? 0x8080808080808080ULL : 0;
+    uint64_t word = 0;
+    if (!transforms_text<ds_type> && i + 8 <= m_size) {
+      std::memcpy(&word, m_text + i, sizeof(word));
+      if constexpr (std::endian::native == std::endian::little) {
+        word = __builtin_bswap64(word);
+      }
+      return word ^ sign_flip;
+    }
+    const size_t len = std::min<size_t>(8, m_size - i);
+    for (size_t k = 0; k < len; ++k) {
+      const uint8_t c = uint8_t(operator[](i + k)) ^ uint8_t(sign_flip);
+      word |= uint64_t(c) << (56 - 8 * k);
+    }
+    return word;
+  }
+
+  // Return lce(i, j) given that it is at least l.
+  size_t lce_from(size_t i, size_t j, size_t l) const {
+    if (i + l >= m_size || j + l >= m_size) {
+      return l;
+    }
+    return l + m_ds.lce(i + l, j + l);
+  }
+
+  // Return whether text[i..] < text[j..] given that their lce is l.
+  bool is_less(size_t i, size_t j, size_t l) const {
+    return i + l == m_size ||
+           (j + l != m_size && operator[](i + l) < operator[](j + l));
+  }
+
+  size_t size() const { return m_size; }
+
+ private:
+  ds_type& m_ds;
+  char_type const* m_text;
+  size_t m_size;
+};
+
+// Merge the sorted runs a and b with their lcp arrays (lcp[k] is the lcp of
+// run[k] and run[k - 1], lcp[0] is ignored) into out. An lce query is only
+// answered if both heads share the same number of symbols with the last
+// output, otherwise the head with the longer lcp is smaller.
+template <typename access_type>
+void lcp_merge(access_type const& access, size_t const* a, size_t const* a_lcp,
+               size_t a_size, size_t const* b, size_t const* b_lcp,
+               size_t b_size, size_t* out, size_t* out_lcp) {
+  size_t x = 0;
+  size_t y = 0;
+  // there is no last output yet, so the first heads are compared directly
+  size_t la = 0;
+  size_t lb = 0;
+  size_t k = 0;
+  while (x < a_size && y < b_size) {
+    bool take_a;
+    if (la != lb) {
+      take_a = la > lb;
+    } else {
+      const size_t l = access.lce_from(a[x], b[y], la);
+      take_a = access.is_less(a[x], b[y], l);
+      if (take_a) {
+        lb = l;
+      } else {
+        la = l;
+      }
+    }
+    if (take_a) {
+      out[k] = a[x];
+      out_lcp[k++] = la;
+      if (++x < a_size) {
+        la = a_lcp[x];
+      }
+    } else {
+      out[k] = b[y];
+      out_lcp[k++] = lb;
+      if (++y < b_size) {
+        lb = b_lcp[y];
+      }
+    }
+  }
+  while (x < a_size) {
+    out[k] = a[x];
+    out_lcp[k++] = la;
+    if (++x < a_size) {
+      la = a_lcp[x];
+    }
+  }
+  while (y < b_size) {
+    out[k] = b[y];
+    out_lcp[k++] = lb;
+    if (++y < b_size) {
+      lb = b_lcp[y];
+    }
+  }
+}
+
+// Sort pos[0, size) with a bottom-up lcp-aware merge sort and write the lcps
+// of neighbours to lcp (lcp[0] is left 0). buf and buf_lcp are scratch space
+// of the same size.
+template <typename access_type>
+void lcp_merge_sort(access_type const& access, size_t* pos, size_t* lcp,
+                    size_t* buf, size_t* buf_lcp, size_t size) {
+  std::fill(lcp, lcp + size, 0);
+  bool in_buf = false;
+  for (size_t width = 1; width < size; width *= 2) {
+    size_t* src = in_buf ? buf : pos;
+    size_t* src_lcp = in_buf ? buf_lcp : lcp;
+    size_t* dst = in_buf ? pos : buf;
+    size_t* dst_lcp = in_buf ? lcp : buf_lcp;
+    for (size_t begin = 0; begin < size; begin += 2 * width) {
+      const size_t mid = std::min(begin + width, size);
+      const size_t end = std::min(begin + 2 * width, size);
+      lcp_merge(access, src + begin, src_lcp + begin, mid - begin, src + mid,
+                src_lcp + mid, end - mid, dst + begin, dst_lcp + begin);
+    }
+    in_buf = !in_buf;
+  }
+  if (in_buf) {
+    std::copy(buf, buf + size, pos);
+    std::copy(buf_lcp, buf_lcp + size, lcp);
+  }
+  if (size != 0) {
+    lcp[0] = 0;
+  }
+}
+
+// Sort pos[0, size) like lcp_merge_sort, but with several threads: the chunks
+// of merge_threshold suffixes are sorted in parallel, then the sorted runs are
+// merged pairwise with lcp_merge, the merges of a round in parallel.
+template <typename access_type>
+void lcp_merge_sort_parallel(access_type const& access, size_t* pos,
+                             size_t* lcp, size_t* buf, size_t* buf_lcp,
+                             size_t size) {
+  const size_t num_chunks = (size + merge_threshold - 1) / merge_threshold;
+#pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < num_chunks; ++c) {
+    const size_t begin = c * merge_threshold;
+    const size_t end = std::min(begin + merge_threshold, size);
+    lcp_merge_sort(access, pos + begin, lcp + begin, buf + begin,
+                   buf_lcp + begin, end - begin);
+  }
+  bool in_buf = false;
+  for (size_t width = merge_threshold; width < size; width *= 2) {
+    size_t* src = in_buf ? buf : pos;
+    size_t* src_lcp = in_buf ? buf_lcp : lcp;
+    size_t* dst = in_buf ? pos : buf;
+    size_t* dst_lcp = in_buf ? lcp : buf_lcp;
+    const size_t num_merges = (size + 2 * width - 1) / (2 * width);
+#pragma omp parallel for schedule(dynamic)
+    for (size_t m = 0; m < num_merges; ++m) {
+      const size_t begin = m * 2 * width;
+      const size_t mid = std::min(begin + width, size);
+      const size_t end = std::min(begin + 2 * width, size);
+      lcp_merge(access, src + begin, src_lcp + begin, mid - begin, src + mid,
+                src_lcp + mid, end - mid, dst + begin, dst_lcp + begin);
+    }
+    in_buf = !in_buf;
+  }
+  if (in_buf) {
+    std::copy(buf, buf + size, pos);
+    std::copy(buf_lcp, buf_lcp + size, lcp);
+  }
+  if (size != 0) {
+    lcp[0] = 0;
+  }
+}
+}  // namespace sparse_sort
+
+// Sort the distinct text positions in positions by their suffixes using the
+// lce queries of ds, which has to be built on text[0, size). If lcp is not
+// null, it is set to the sparse lcp array (lcp[k] is the lce of positions[k]
+// and positions[k - 1], lcp[0] = 0).
+//
+// The suffixes are first sorted in parallel by their first 8 symbols. Groups
+// with the same 8 symbols are then sorted by an lcp-aware merge sort, which
+// reuses the lces of neighbours, so every comparison of a merge answers at
+// most one lce query and the lcps come out of the sort. Small groups are
+// sorted by one thread each, large ones by all threads (see
+// lcp_merge_sort_parallel). The queries of ds have to be thread safe.
+template <typename ds_type, typename char_type, typename index_type>
+void sparse_suffix_sort(ds_type& ds, char_type const* text, size_t size,
+                        std::vector<index_type>& positions,
+                        std::vector<index_type>* lcp = nullptr) {
+  const sparse_sort::suffix_access<ds_type, char_type> access(ds, text, size);
+  const size_t n = positions.size();
+
+  // 1. sort by the first 8 symbols
+  std::vector<std::pair<uint64_t, index_type>> keys(n);
+#pragma omp parallel for
+  for (size_t k = 0; k < n; ++k) {
+    assert(positions[k] < size);
+    keys[k] = {access.key(positions[k]), positions[k]};
+  }
+  ips4o::parallel::sort(
+      keys.begin(), keys.end(),
+      [](auto const& a, auto const& b) { return a.first < b.first; });
+
+  // borders of the groups with the same key
+  std::vector<size_t> groups;
+  for (size_t k = 0; k < n; ++k) {
+    if (k == 0 || keys[k].first != keys[k - 1].first) {
+      groups.push_back(k);
+    }
+  }
+  groups.push_back(n);
+  const size_t num_groups = groups.size() - 1;
+
+  std::vector<size_t> lcps;
+  if (lcp != nullptr) {
+    lcps.resize(n);
+  }
+
+  // 2. sort the groups, small ones with one thread each
+#pragma omp parallel
+  {
+    std::vector<size_t> pos;
+    std::vector<size_t> pos_lcp;
+    std::vector<size_t> buf;
+    std::vector<size_t> buf_lcp;
+#pragma omp for schedule(dynamic)
+    for (size_t g = 0; g < num_groups; ++g) {
+      const size_t begin = groups[g];
+      const size_t size_g = groups[g + 1] - begin;
+      if (size_g == 1 || size_g > sparse_sort::merge_threshold) {
+        continue;
+      }
+      pos.resize(size_g);
+      pos_lcp.resize(size_g);
+      buf.resize(size_g);
+      buf_lcp.resize(size_g);
+      for (size_t k = 0; k < size_g; ++k) {
+        pos[k] = keys[begin + k].second;
+      }
+      sparse_sort::lcp_merge_sort(access, pos.data(), pos_lcp.data(),
+                                  buf.data(), buf_lcp.data(), size_g);
+      for (size_t k = 0; k < size_g; ++k) {
+        keys[begin + k].second = pos[k];
+      }
+      if (lcp != nullptr) {
+        std::copy(pos_lcp.begin() + 1, pos_lcp.end(),
+                  lcps.begin() + begin + 1);
+      }
+    }
+  }
+
+  for (size_t g = 0; g < num_groups; ++g) {
+    const size_t begin = groups[g];
+    const size_t size_g = groups[g + 1] - begin;
+    if (size_g <= sparse_sort::merge_threshold) {
+      continue;
+    }
+    std::vector<size_t> pos(size_g);
+    std::vector<size_t> pos_lcp(size_g);
+    std::vector<size_t> buf(size_g);
+    std::vector<size_t> buf_lcp(size_g);
+#pragma omp parallel for
+    for (size_t k = 0; k < size_g; ++k) {
+      pos[k] = keys[begin + k].second;
+    }
+    sparse_sort::lcp_merge_sort_parallel(access, pos.data(), pos_lcp.data(),
+                                         buf.data(), buf_lcp.data(), size_g);
+#pragma omp parallel for
+    for (size_t k = 0; k < size_g; ++k) {
+      keys[begin + k].second = pos[k];
+    }
+    if (lcp != nullptr) {
+      std::copy(pos_lcp.begin() + 1, pos_lcp.end(), lcps.begin() + begin + 1);
+    }
+  }
+
+  // 3. the lcp of the first suffix of a group and its predecessor follows
+  // from the keys, but can't exceed the shorter suffix (the keys are padded)
+  if (lcp != nullptr) {
+#pragma omp parallel for
+    for (size_t g = 1; g < num_groups; ++g) {
+      const size_t k = groups[g];
+      const uint64_t diff = keys[k - 1].first ^ keys[k].first;
+      const size_t a = keys[k - 1].second;
+      const size_t b = keys[k].second;
+      lcps[k] = std::min<size_t>(std::countl_zero(diff) / 8,
+                                 size - std::max(a, b));
+    }
+    lcp->resize(n);
+#pragma omp parallel for
+    for (size_t k = 0; k < n; ++k) {
+      (*lcp)[k] = lcps[k];
+    }
+  }
+
+#pragma omp parallel for
+  for (size_t k = 0; k < n; ++k) {
+    positions[k] = keys[k].second;
+  }
+}
+
+template <typename ds_type, typename C, typename index_type>
+void sparse_suffix_sort(ds_type& ds, C const& text,
+                        std::vector<index_type>& positions,
+                        std::vector<index_type>* lcp = nullptr) {
+  sparse_suffix_sort(ds, text.data(), text.size(), positions, lcp);
+}
+}  // namespace lce::ds
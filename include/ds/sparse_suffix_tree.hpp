@@ -0,0 +1,216 @@
+/*******************************************************************************
+ * lce/ds/sparse_suffix_tree.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace lce::ds {
+
+// The sparse suffix tree of the synchronizing positions of an lce_sss that was
+// built with keep_sa, as an enhanced sparse suffix array: the suffix array and
+// LCP array of lce_classic_for_sss and the LCP-interval tree on top of them,
+// which is traversed bottom-up with a stack (Abouelhoda et al., Replacing
+// suffix trees with enhanced suffix arrays). It only keeps a pointer to the
+// lce_sss and needs no memory besides the suffix array.
+//
+// An interval [lb, rb] of ranks with value lcp is a node of the tree: the
+// suffixes at the synchronizing positions of these ranks share exactly lcp
+// letters, which are all in the text (lcp values are not capped at 3 * tau).
+template <typename ds_type>
+class sparse_suffix_tree {
+ public:
+  struct interval {
+    uint64_t lcp;
+    uint64_t lb;
+    uint64_t rb;
+  };
+
+  // A substring of length length that occurs at all positions (sorted).
+  struct repeat {
+    uint64_t length;
+    std::vector<uint64_t> positions;
+  };
+
+  sparse_suffix_tree(ds_type const& ds)
+      : m_ds(&ds), m_size(ds.sparse_index().size()) {
+    assert(ds.sparse_index().sa().size() == m_size);
+  }
+
+  // The number of sparse suffixes.
+  size_t size() const {
+    return m_size;
+  }
+
+  uint64_t tau() const {
+    return m_ds->tau();
+  }
+
+  // Return the text position of the suffix of rank k.
+  size_t position(size_t k) const {
+    return m_ds->sync_position(m_ds->sparse_index().sa()[k]);
+  }
+
+  // Return the number of common letters of the suffixes of rank k - 1 and k.
+  size_t lcp(size_t k) const {
+    return m_ds->sparse_index().lcp()[k];
+  }
+
+  // Return the rank of the suffix at the k-th synchronizing position.
+  size_t rank(size_t k) const {
+    return m_ds->sparse_index().isa()[k];
+  }
+
+  // Return the ranks of all suffixes that share at least min_lcp letters with
+  // the suffix of rank k and the number of letters they all share. This takes
+  // time linear in the number of the ranks.
+  interval sharing_prefix(size_t k, size_t min_lcp) const {
+    size_t lb = k;
+    size_t rb = k;
+    uint64_t shared = m_ds->size() - position(k);
+    while (lb > 0 && lcp(lb) >= min_lcp) {
+      shared = std::min<uint64_t>(shared, lcp(lb--));
+    }
+    while (rb + 1 < m_size && lcp(rb + 1) >= min_lcp) {
+      shared = std::min<uint64_t>(shared, lcp(++rb));
+    }
+    return {shared, lb, rb};
+  }
+
+  // Call f(x) for every text position x (including i) with lce(i, x) >=
+  // min_lcp, in no particular order. The occurrences are found with the
+  // successor i + d of i: every x has the synchronizing position x + d and
+  // shares min_lcp - d letters with it, if min_lcp >= d + 2 * tau (which holds
+  // for min_lcp >= 3 * tau unless i is in a run). Otherwise, or if i has no
+  // successor, the occurrences are found by comparing i with every position,
+  // which takes n lce queries.
+  template <typename F>
+  void for_each_occurrence(size_t i, size_t min_lcp, F&& f) const {
+    const size_t n = m_ds->size();
+    if (min_lcp > n - i) {
+      return;
+    }
+    const auto succ = m_ds->successor(i);
+    if (!succ.exists || min_lcp < succ.pos - i + 2 * tau()) [[unlikely]] {
+      // only positions with at least min_lcp (and one) letters left
+      const size_t last = n - std::max<size_t>(min_lcp, 1);
+      for (size_t x = 0; x <= last; ++x) {
+        if (m_ds->lce(i, x) >= min_lcp) {
+          f(x);
+        }
+      }
+      return;
+    }
+    const size_t d = succ.pos - i;
+    const interval iv = sharing_prefix(rank(succ.idx), min_lcp - d);
+    for (size_t k = iv.lb; k <= iv.rb; ++k) {
+      const size_t y = position(k);
+      if (y >= d && m_ds->lce(i, y - d) >= min_lcp) {
+        f(y - d);
+      }
+    }
+  }
+
+  // Call f(interval) for every lcp-interval with value at least min_lcp,
+  // children before their parents.
+  template <typename F>
+  void for_each_interval(size_t min_lcp, F&& f) const {
+    // the open intervals as (lcp, lb)
+    std::vector<std::pair<uint64_t, uint64_t>> stack{{0, 0}};
+    for (size_t k = 1; k <= m_size; ++k) {
+      const uint64_t l = (k < m_size) ? lcp(k) : 0;
+      uint64_t lb = k - 1;
+      while (l < stack.back().first) {
+        const auto [top_lcp, top_lb] = stack.back();
+        stack.pop_back();
+        lb = top_lb;
+        if (top_lcp >= min_lcp) {
+          f(interval{top_lcp, top_lb, k - 1});
+        }
+      }
+      if (l > stack.back().first) {
+        stack.emplace_back(l, lb);
+      }
+    }
+    if (min_lcp == 0 && m_size > 0) {
+      f(interval{0, 0, m_size - 1});
+    }
+  }
+
+  // Return the longest repeats among the sparse suffixes if they have at least
+  // min_length letters: the deepest lcp-intervals, extended to the left by the
+  // letters that precede all of their occurrences. A repeat of length l >=
+  // 3 * tau (outside of runs) has synchronizing positions at the same offset
+  // d < tau in all occurrences, so the longest repeat of the text is at most
+  // tau - 1 letters longer than the result.
+  std::vector<repeat> longest_repeats() const {
+    return longest_repeats(3 * tau());
+  }
+
+  std::vector<repeat> longest_repeats(size_t min_length) const {
+    uint64_t max_lcp = 0;
+#pragma omp parallel for reduction(max : max_lcp)
+    for (size_t k = 1; k < m_size; ++k) {
+      max_lcp = std::max<uint64_t>(max_lcp, lcp(k));
+    }
+    std::vector<repeat> result;
+    if (max_lcp == 0) {
+      return result;
+    }
+
+    for (size_t k = 1; k < m_size; ++k) {
+      if (lcp(k) != max_lcp) {
+        continue;
+      }
+      repeat r{max_lcp, {position(k - 1)}};
+      for (; k < m_size && lcp(k) == max_lcp; ++k) {
+        r.positions.push_back(position(k));
+      }
+      std::sort(r.positions.begin(), r.positions.end());
+      extend_left(r);
+      if (r.length < min_length) {
+        continue;
+      }
+      if (!result.empty() && r.length > result.front().length) {
+        result.clear();
+      }
+      if (result.empty() || r.length == result.front().length) {
+        result.push_back(std::move(r));
+      }
+    }
+    return result;
+  }
+
+ private:
+  ds_type const* m_ds;
+  size_t m_size;
+
+  // Move the occurrences of r to the left while they are preceded by the same
+  // letter.
+  void extend_left(repeat& r) const {
+    while (r.positions.front() > 0) {
+      const auto c = (*m_ds)[r.positions.front() - 1];
+      for (auto const& p : r.positions) {
+        if ((*m_ds)[p - 1] != c) {
+          return;
+        }
+      }
+      for (auto& p : r.positions) {
+        --p;
+      }
+      ++r.length;
+    }
+  }
+};
+}  // namespace lce::ds
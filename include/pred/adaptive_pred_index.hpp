@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * lce/pred/adaptive_pred_index.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "batch_search.hpp"
+#include "pred_result.hpp"
+
+namespace lce::pred {
+
+// The "idx" data structure of pred_index, but the number of low bits is chosen
+// at construction time from the density of the data, such that a bucket holds
+// about t_keys_per_bucket keys on average. The high bits are taken relative to
+// the minimum. So the table has O(n / t_keys_per_bucket) entries, regardless
+// of the universe (pred_index needs max >> lo_bits entries, which dominates
+// for sparse data).
+template <typename T, typename index_type = uint32_t,
+          uint64_t t_keys_per_bucket = 4>
+class adaptive_pred_index {
+ public:
+  typedef T data_type;
+
+  inline adaptive_pred_index()
+      : m_data(nullptr), m_size(0), m_min(0), m_max(0), m_lo_bits(0) {
+  }
+
+  template <typename C>
+  adaptive_pred_index(C const& container)
+      : adaptive_pred_index(container.data(), container.size()) {
+  }
+
+  inline adaptive_pred_index(T const* data, size_t size)
+      : m_data(data), m_size(size), m_min(data[0]), m_max(data[size - 1]) {
+    assert(std::is_sorted(m_data, m_data + size));
+
+    // about floor(log(bucket width)), where a bucket covers t_keys_per_bucket
+    // average gaps
+    const uint64_t gap = offset(m_max) / m_size;
+    const uint64_t log_gap = (gap > 1) ? std::bit_width(gap) - 1 : 0;
+    m_lo_bits = std::min<uint64_t>(
+        63, log_gap + std::bit_width(t_keys_per_bucket) - 1);
+
+    // build an index for high bits
+    m_hi_idx.resize(hi(m_max) + 2);
+#pragma omp parallel
+    {
+      const int t = omp_get_thread_num();
+      const int nt = omp_get_num_threads();
+      const size_t slice_size = m_size / nt;
+      const size_t start_i = t * slice_size;
+      const size_t end_i = (t < nt - 1) ? (t + 1) * slice_size : m_size;
+
+      if (t == 0) {
+        m_hi_idx[0] = 0;
+      }
+      uint64_t prev_key = (t == 0) ? 0 : hi(data[start_i - 1]);
+      for (size_t i = start_i; i < end_i; ++i) {
+        const uint64_t cur_key = hi(data[i]);
+        if (cur_key > prev_key) {
+          for (uint64_t key = prev_key + 1; key <= cur_key; key++) {
+            m_hi_idx[key] = i;
+          }
+          prev_key = cur_key;
+        }
+      }
+    }
+    m_hi_idx[hi(m_max) + 1] = m_size;
+  }
+
+  // finds the greatest element less than OR equal to x
+  inline result predecessor(const T x) const {
+    if (x < m_min) [[unlikely]]
+      return result{false, 0};
+    if (x >= m_max) [[unlikely]]
+      return result{true, m_size - 1};
+
+    const auto [p, q] = window(x);
+    return {true, static_cast<size_t>(
+                      std::distance(m_data, std::upper_bound(m_data + p,
+                                                             m_data + q, x)) -
+                      1)};
+  }
+
+  // finds the smallest element greater than OR equal to x
+  inline result successor(const T x) const {
+    if (x <= m_min) [[unlikely]]
+      return result{true, 0};
+    if (x > m_max) [[unlikely]]
+      return result{false, 0};
+
+    const auto [p, q] = window(x);
+    return {true, static_cast<size_t>(std::distance(
+                      m_data, std::lower_bound(m_data + p, m_data + q, x)))};
+  }
+
+  inline void predecessor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<true>(m_data, m_size, m_min, m_max, keys, num, out,
+                       [&](const T x) { return window(x); });
+  }
+
+  inline void successor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<false>(m_data, m_size, m_min, m_max, keys, num, out,
+                        [&](const T x) { return window(x); });
+  }
+
+  uint64_t lo_bits() const {
+    return m_lo_bits;
+  }
+
+  size_t size_in_bytes() const {
+    return m_hi_idx.size() * sizeof(index_type);
+  }
+
+ private:
+  inline uint64_t offset(const T x) const {
+    return uint64_t(x) - uint64_t(m_min);
+  }
+
+  inline uint64_t hi(const T x) const {
+    return offset(x) >> m_lo_bits;
+  }
+
+  inline std::pair<size_t, size_t> window(const T x) const {
+    const uint64_t key = hi(x);
+    return {m_hi_idx[key], m_hi_idx[key + 1]};
+  }
+
+  T const* m_data;
+  size_t m_size;
+  T m_min;
+  T m_max;
+
+  uint64_t m_lo_bits;
+  std::vector<index_type> m_hi_idx;
+};
+}  // namespace lce::pred
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * lce/pred/batch_search.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "pred_result.hpp"
+
+namespace lce::pred {
+
+// The predecessor indices have predecessor_batch(keys, num, out) and
+// successor_batch(keys, num, out), which answer the queries keys[0..num) like
+// predecessor and successor and write the results to out[0..num). Most of
+// them call batch_search with the window of their scalar queries.
+
+// number of binary searches that advance in lockstep
+static constexpr size_t batch_group_size = 16;
+
+// Answer num predecessor (t_pred = true) or successor (t_pred = false)
+// queries keys[0..num) on the sorted array data[0..size) and write the results
+// to out[0..num). For keys within [min, max], window(x) has to return a pair
+// [p, q) of positions that contains the position of the lower bound (successor)
+// or upper bound (predecessor) of x, or q itself if the bound is q. If p == q,
+// then p has to be smaller than size.
+//
+// The searches of up to batch_group_size keys are interleaved: every round
+// halves the window of each key with a branchless step and prefetches the
+// next probe, so the cache misses of different keys overlap.
+template <bool t_pred, typename T, typename K, typename F>
+inline void batch_search(T const* data, size_t size, T const min, T const max,
+                         K const* keys, size_t num, result* out, F&& window) {
+  // results are collected locally and written at the end of a group, so
+  // stores to out can't alias the search state
+  size_t base[batch_group_size];
+  size_t len[batch_group_size];
+  bool in_range[batch_group_size];
+  result res[batch_group_size];
+
+  for (size_t g = 0; g < num; g += batch_group_size) {
+    const size_t group = std::min(batch_group_size, num - g);
+    K const* const x = keys + g;
+
+    // bounds checks and initial windows
+    size_t max_len = 1;
+    for (size_t i = 0; i < group; ++i) {
+      if constexpr (t_pred) {
+        in_range[i] = x[i] >= min && x[i] < max;
+        res[i] = {x[i] >= min, x[i] >= max ? size - 1 : 0};
+      } else {
+        in_range[i] = x[i] > min && x[i] <= max;
+        res[i] = {x[i] <= max, 0};
+      }
+      base[i] = 0;
+      len[i] = 0;
+      if (in_range[i]) {
+        const auto [p, q] = window(x[i]);
+        base[i] = p;
+        len[i] = q - p;
+        max_len = std::max(max_len, len[i]);
+        __builtin_prefetch(data + p + (len[i] >> 1));
+      }
+    }
+
+    // lockstep binary search, every window keeps ceil(len / 2) elements (empty
+    // windows stay empty and only probe data[base])
+    while (max_len > 1) {
+      for (size_t i = 0; i < group; ++i) {
+        const size_t half = len[i] >> 1;
+        const bool right = t_pred ? (data[base[i] + half] <= x[i])
+                                  : (data[base[i] + half] < x[i]);
+        base[i] += right ? half : 0;
+        len[i] -= half;
+        __builtin_prefetch(data + base[i] + (len[i] >> 1));
+      }
+      max_len -= max_len >> 1;
+    }
+
+    for (size_t i = 0; i < group; ++i) {
+      if (in_range[i]) {
+        // don't touch data for empty windows, e.g. empty buckets of pred_index
+        const size_t bound =
+            base[i] + (len[i] != 0 && (t_pred ? (data[base[i]] <= x[i])
+                                              : (data[base[i]] < x[i])));
+        res[i] = {true, t_pred ? bound - 1 : bound};
+      }
+    }
+    std::copy_n(res, group, out + g);
+  }
+}
+}  // namespace lce::pred
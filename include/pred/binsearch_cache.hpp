@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <iterator>
 
+#include "batch_search.hpp"
 #include "pred_result.hpp"
 
 namespace lce::pred {
@@ -21,6 +22,7 @@ namespace lce::pred {
 template<typename T, size_t m_cache_num = 512ULL / sizeof(T)>
 class binsearch_cache {
 public:
+  typedef T data_type;
   inline binsearch_cache() : m_data(nullptr), m_size(0), m_min(), m_max() {
   }
 
@@ -75,7 +77,7 @@ public:
   // finds the smallest element greater than OR equal to x
   // seeded using a start interval
   inline result successor_seeded(const T x, size_t p, size_t q) const {
-    assert(x >= m_min && x < m_max);
+    assert(x > m_min && x <= m_max);
     while(q - p > m_cache_num) {
       assert(x > m_data[p]);
       assert(x <= m_data[q]);
@@ -108,6 +110,18 @@ public:
     return successor_seeded(x, 0, m_size - 1);
   }
 
+  // the window of every key is the whole array
+  inline void predecessor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<true>(m_data, m_size, m_min, m_max, keys, num, out,
+                       [&](T) { return std::pair<size_t, size_t>{0, m_size}; });
+  }
+
+  inline void successor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<false>(
+        m_data, m_size, m_min, m_max, keys, num, out,
+        [&](T) { return std::pair<size_t, size_t>{0, m_size}; });
+  }
+
 protected:
   T const* m_data = nullptr;
   size_t m_size = 0;
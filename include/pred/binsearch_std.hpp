@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <iterator>
 
+#include "batch_search.hpp"
 #include "pred_result.hpp"
 
 namespace lce::pred {
@@ -62,6 +63,18 @@ class binsearch_std {
     return std::distance(m_data, std::lower_bound(m_data, m_data + m_size, x));
   }
 
+  // the window of every key is the whole array
+  void predecessor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<true>(m_data, m_size, m_min, m_max, keys, num, out,
+                       [&](T) { return std::pair<size_t, size_t>{0, m_size}; });
+  }
+
+  void successor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<false>(
+        m_data, m_size, m_min, m_max, keys, num, out,
+        [&](T) { return std::pair<size_t, size_t>{0, m_size}; });
+  }
+
   bool contains(T x) const {
     auto const it = std::lower_bound(m_data, m_data + m_size, x);
     return (it != m_data + m_size) && (*it == x);
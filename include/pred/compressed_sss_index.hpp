@@ -0,0 +1,246 @@
+/*******************************************************************************
+ * lce/pred/compressed_sss_index.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "pred_result.hpp"
+
+namespace lce::pred {
+
+// Delta compressed sorted positions (e.g. a string synchronizing set, where
+// consecutive positions are at most tau apart outside of runs). Every
+// t_block_size-th entry is stored as an absolute anchor, the other entries of
+// its block as deltas to their predecessor, packed with the bit width of the
+// largest delta in the block. A query looks up the anchors with the same high
+// bits in a small table, binary searches them and decodes a single block. The
+// data itself is not needed after construction.
+template <typename T, uint64_t t_block_size = 32>
+class compressed_sss_index {
+ public:
+  typedef T data_type;
+
+  inline compressed_sss_index() : m_size(0), m_min(0), m_max(0), m_shift(0) {
+  }
+
+  template <typename C>
+  compressed_sss_index(C const& container)
+      : compressed_sss_index(container.data(), container.size()) {
+  }
+
+  inline compressed_sss_index(T const* data, size_t size)
+      : m_size(size), m_min(data[0]), m_max(data[size - 1]) {
+    assert(std::is_sorted(data, data + size));
+    const size_t num_blocks = div_ceil(m_size, t_block_size);
+    m_anchors.resize(num_blocks);
+    m_widths.resize(num_blocks);
+    m_offsets.resize(num_blocks + 1);
+
+    // anchors and bit widths of the blocks
+#pragma omp parallel for
+    for (size_t b = 0; b < num_blocks; ++b) {
+      const size_t begin = b * t_block_size;
+      const size_t end = std::min(begin + t_block_size, m_size);
+      uint64_t max_delta = 0;
+      for (size_t i = begin + 1; i < end; ++i) {
+        max_delta = std::max(max_delta, uint64_t(data[i]) - uint64_t(data[i - 1]));
+      }
+      m_anchors[b] = data[begin];
+      m_widths[b] = std::bit_width(max_delta);
+    }
+
+    m_offsets[0] = 0;
+    for (size_t b = 0; b < num_blocks; ++b) {
+      const size_t num_deltas =
+          std::min(t_block_size, m_size - b * t_block_size) - 1;
+      m_offsets[b + 1] = m_offsets[b] + num_deltas * m_widths[b];
+    }
+
+    // hi table: entry p is the first anchor whose high bits are >= p, there
+    // is about one entry per block
+    const uint64_t key_bits = std::bit_width(offset(m_max));
+    const uint64_t table_bits = std::bit_width(num_blocks);
+    m_shift = (key_bits > table_bits) ? key_bits - table_bits : 0;
+    m_hi_table.resize((offset(m_max) >> m_shift) + 2);
+    uint64_t prefix = 0;
+    m_hi_table[0] = 0;
+    for (size_t b = 0; b < num_blocks; ++b) {
+      const uint64_t cur_prefix = offset(m_anchors[b]) >> m_shift;
+      for (; prefix < cur_prefix; ++prefix) {
+        m_hi_table[prefix + 1] = b;
+      }
+    }
+    for (; prefix + 1 < m_hi_table.size(); ++prefix) {
+      m_hi_table[prefix + 1] = num_blocks;
+    }
+
+    // one word of padding lets us read two words without bounds checks
+    m_deltas.resize(m_offsets[num_blocks] / 64 + 2, 0);
+
+    // blocks may share their first and last word with the neighbouring blocks
+#pragma omp parallel for
+    for (size_t b = 0; b < num_blocks; ++b) {
+      const size_t begin = b * t_block_size;
+      const size_t end = std::min(begin + t_block_size, m_size);
+      uint64_t pos = m_offsets[b];
+      for (size_t i = begin + 1; i < end; ++i) {
+        write(pos, uint64_t(data[i]) - uint64_t(data[i - 1]));
+        pos += m_widths[b];
+      }
+    }
+  }
+
+  // Return the i-th entry.
+  inline T access(size_t i) const {
+    assert(i < m_size);
+    const size_t b = i / t_block_size;
+    const uint64_t width = m_widths[b];
+    const uint64_t mask = bit_mask(width);
+    uint64_t pos = m_offsets[b];
+    uint64_t value = uint64_t(m_anchors[b]);
+    for (size_t j = b * t_block_size; j < i; ++j) {
+      value += read(pos, mask);
+      pos += width;
+    }
+    return static_cast<T>(value);
+  }
+
+  inline T operator[](size_t i) const {
+    return access(i);
+  }
+
+  // finds the greatest element less than OR equal to x
+  inline result predecessor(const T x) const {
+    if (x < m_min) [[unlikely]]
+      return result{false, 0};
+    if (x >= m_max) [[unlikely]]
+      return result{true, m_size - 1};
+
+    // last anchor not greater than x, then the last entry of its block that
+    // is not greater than x
+    const size_t b = anchor_bound<true>(x) - 1;
+    const size_t end = std::min(b * t_block_size + t_block_size, m_size);
+    const uint64_t width = m_widths[b];
+    const uint64_t mask = bit_mask(width);
+    uint64_t pos = m_offsets[b];
+    uint64_t value = uint64_t(m_anchors[b]);
+    size_t i = b * t_block_size;
+    while (i + 1 < end) {
+      value += read(pos, mask);
+      if (value > uint64_t(x)) {
+        break;
+      }
+      pos += width;
+      ++i;
+    }
+    return {true, i};
+  }
+
+  // finds the smallest element greater than OR equal to x
+  inline result successor(const T x) const {
+    if (x <= m_min) [[unlikely]]
+      return result{true, 0};
+    if (x > m_max) [[unlikely]]
+      return result{false, 0};
+
+    // the successor is in the block of the last anchor less than x or it is
+    // the next anchor
+    const size_t b = anchor_bound<false>(x) - 1;
+    const size_t end = std::min(b * t_block_size + t_block_size, m_size);
+    const uint64_t width = m_widths[b];
+    const uint64_t mask = bit_mask(width);
+    uint64_t pos = m_offsets[b];
+    uint64_t value = uint64_t(m_anchors[b]);
+    size_t i = b * t_block_size + 1;
+    for (; i < end; ++i) {
+      value += read(pos, mask);
+      if (value >= uint64_t(x)) {
+        break;
+      }
+      pos += width;
+    }
+    return {true, i};
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+  size_t size_in_bytes() const {
+    return m_anchors.size() * sizeof(T) + m_widths.size() +
+           m_hi_table.size() * sizeof(uint32_t) +
+           m_offsets.size() * sizeof(uint64_t) +
+           m_deltas.size() * sizeof(uint64_t);
+  }
+
+ private:
+  inline uint64_t offset(const T x) const {
+    return uint64_t(x) - uint64_t(m_min);
+  }
+
+  // Return the index of the first anchor greater (t_upper) or not less than
+  // x. Here x must be within [m_min, m_max].
+  template <bool t_upper>
+  inline size_t anchor_bound(const T x) const {
+    const uint64_t prefix = offset(x) >> m_shift;
+    auto begin = m_anchors.begin() + m_hi_table[prefix];
+    auto end = m_anchors.begin() + m_hi_table[prefix + 1];
+    if constexpr (t_upper) {
+      return std::distance(m_anchors.begin(), std::upper_bound(begin, end, x));
+    } else {
+      return std::distance(m_anchors.begin(), std::lower_bound(begin, end, x));
+    }
+  }
+
+  inline static uint64_t div_ceil(uint64_t x, uint64_t y) {
+    return x == 0 ? 0 : (1 + (x - 1) / y);
+  }
+
+  inline static uint64_t bit_mask(uint64_t width) {
+    return width >= 64 ? UINT64_MAX : (uint64_t{1} << width) - 1;
+  }
+
+  inline uint64_t read(uint64_t pos, uint64_t mask) const {
+    const uint64_t word = pos >> 6;
+    const uint64_t shift = pos & 63;
+    // the second word only contributes if the value crosses the word border
+    const uint64_t hi = (m_deltas[word + 1] << 1) << (63 - shift);
+    return ((m_deltas[word] >> shift) | hi) & mask;
+  }
+
+  inline void write(uint64_t pos, uint64_t value) {
+    const uint64_t word = pos >> 6;
+    const uint64_t shift = pos & 63;
+    std::atomic_ref<uint64_t>(m_deltas[word]).fetch_or(
+        value << shift, std::memory_order_relaxed);
+    if (shift != 0 && (value >> (64 - shift)) != 0) {
+      std::atomic_ref<uint64_t>(m_deltas[word + 1])
+          .fetch_or(value >> (64 - shift), std::memory_order_relaxed);
+    }
+  }
+
+  size_t m_size;
+  T m_min;
+  T m_max;
+
+  uint64_t m_shift;
+  std::vector<uint32_t> m_hi_table;
+  std::vector<T> m_anchors;
+  std::vector<uint8_t> m_widths;
+  std::vector<uint64_t> m_offsets;
+  std::vector<uint64_t> m_deltas;
+};
+}  // namespace lce::pred
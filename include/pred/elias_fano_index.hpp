@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * lce/pred/elias_fano_index.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "../bit_vector/bit_select.hpp"
+#include "../bit_vector/bit_vector.hpp"
+#include "../bit_vector/int_vector.hpp"
+#include "../bit_vector/util.hpp"
+#include "pred_result.hpp"
+
+namespace lce::pred {
+
+// Elias-Fano coding of the sorted data (relative to the minimum). The low
+// floor(log(u/n)) bits of each entry are stored in an int_vector, the high
+// bits are stored in unary in a bit vector with n + (u >> lo_bits) + 1 bits,
+// i.e. about 2 + log(u/n) bits per entry. The data itself is not needed after
+// construction, access(i) decodes the i-th entry.
+//
+// Every t_sample_rate-th 0-bit of the high bits is sampled. A query jumps to
+// the bucket of its high bits using the samples, then it scans the (few)
+// entries of the bucket.
+template <typename T, uint64_t t_sample_rate = 64>
+class elias_fano_index {
+ public:
+  typedef T data_type;
+
+  inline elias_fano_index() : m_size(0), m_min(0), m_max(0), m_lo_bits(0) {
+  }
+
+  template <typename C>
+  elias_fano_index(C const& container)
+      : elias_fano_index(container.data(), container.size()) {
+  }
+
+  inline elias_fano_index(T const* data, size_t size)
+      : m_size(size), m_min(data[0]), m_max(data[size - 1]) {
+    assert(std::is_sorted(data, data + size));
+
+    const uint64_t universe = uint64_t(m_max) - uint64_t(m_min) + 1;
+    m_lo_bits = (universe > m_size) ? std::bit_width(universe / m_size) - 1 : 0;
+    m_lo_mask = bit_mask(m_lo_bits);
+
+    m_high = stash::bit_vector(m_size + (offset(m_max) >> m_lo_bits) + 1);
+    if (m_lo_bits > 0) {
+      m_low = stash::int_vector(m_size, m_lo_bits);
+    }
+    for (size_t i = 0; i < m_size; ++i) {
+      const uint64_t y = offset(data[i]);
+      m_high[(y >> m_lo_bits) + i] = 1;
+      if (m_lo_bits > 0) {
+        m_low[i] = y & m_lo_mask;
+      }
+    }
+
+    // sample the positions directly after every t_sample_rate-th 0-bit
+    m_zero_samples.push_back(0);
+    size_t zeros = 0;
+    for (size_t i = 0; i < m_high.num_blocks(); ++i) {
+      uint64_t w = ~m_high.block64(i);
+      const size_t c = std::popcount(w);
+      while (zeros + c >= t_sample_rate * m_zero_samples.size()) {
+        const size_t k = t_sample_rate * m_zero_samples.size() - zeros;
+        m_zero_samples.push_back((i << 6) + select1_u64(w, k) + 1);
+      }
+      zeros += c;
+    }
+
+    m_select = stash::bit_select<1>(m_high);
+  }
+
+  // the select structure points to m_high, which moves with the object
+  inline elias_fano_index(elias_fano_index const& other) {
+    *this = other;
+  }
+
+  inline elias_fano_index(elias_fano_index&& other) {
+    *this = std::move(other);
+  }
+
+  inline elias_fano_index& operator=(elias_fano_index const& other) {
+    copy_members(other);
+    m_high = other.m_high;
+    m_low = other.m_low;
+    m_zero_samples = other.m_zero_samples;
+    m_select.reassign(stash::bit_select<1>(other.m_select), m_high);
+    return *this;
+  }
+
+  inline elias_fano_index& operator=(elias_fano_index&& other) {
+    copy_members(other);
+    m_high = std::move(other.m_high);
+    m_low = std::move(other.m_low);
+    m_zero_samples = std::move(other.m_zero_samples);
+    m_select.reassign(std::move(other.m_select), m_high);
+    return *this;
+  }
+
+  // Return the i-th entry.
+  inline T access(size_t i) const {
+    assert(i < m_size);
+    const uint64_t hi = m_select.select(i + 1) - i;
+    return static_cast<T>(uint64_t(m_min) + ((hi << m_lo_bits) | low(i)));
+  }
+
+  inline T operator[](size_t i) const {
+    return access(i);
+  }
+
+  // finds the greatest element less than OR equal to x
+  inline result predecessor(const T x) const {
+    if (x < m_min) [[unlikely]]
+      return result{false, 0};
+    if (x >= m_max) [[unlikely]]
+      return result{true, m_size - 1};
+
+    return {true, bound<true>(offset(x)) - 1};
+  }
+
+  // finds the smallest element greater than OR equal to x
+  inline result successor(const T x) const {
+    if (x <= m_min) [[unlikely]]
+      return result{true, 0};
+    if (x > m_max) [[unlikely]]
+      return result{false, 0};
+
+    return {true, bound<false>(offset(x))};
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+ private:
+  inline uint64_t offset(const T x) const {
+    return uint64_t(x) - uint64_t(m_min);
+  }
+
+  inline uint64_t low(size_t i) const {
+    return (m_lo_bits > 0) ? uint64_t(m_low[i]) : 0;
+  }
+
+  // Return the position directly after the h-th 0-bit of the high bits, i.e.
+  // the position of the first entry of bucket h.
+  inline size_t bucket_begin(const uint64_t h) const {
+    const size_t j = h / t_sample_rate;
+    const size_t pos = m_zero_samples[j];
+    size_t r = h - j * t_sample_rate;
+    if (r == 0) {
+      return pos;
+    }
+
+    size_t i = pos >> 6;
+    uint64_t w = ~m_high.block64(i) & (UINT64_MAX << (pos & 63));
+    size_t c = std::popcount(w);
+    while (c < r) {
+      r -= c;
+      w = ~m_high.block64(++i);
+      c = std::popcount(w);
+    }
+    return (i << 6) + select1_u64(w, r) + 1;
+  }
+
+  // Return the index of the first entry greater (t_upper) or not less than
+  // y, where y is relative to m_min. Such an entry has to exist.
+  template <bool t_upper>
+  inline size_t bound(const uint64_t y) const {
+    const uint64_t h = y >> m_lo_bits;
+    const uint64_t y_lo = y & m_lo_mask;
+
+    size_t pos = bucket_begin(h);
+    size_t i = pos - h;
+    // the entries of bucket h are the 1-bits up to the next 0-bit
+    while (m_high[pos]) {
+      const uint64_t lo = low(i);
+      if (t_upper ? (lo > y_lo) : (lo >= y_lo)) {
+        return i;
+      }
+      ++pos;
+      ++i;
+    }
+    return i;
+  }
+
+  inline void copy_members(elias_fano_index const& other) {
+    m_size = other.m_size;
+    m_min = other.m_min;
+    m_max = other.m_max;
+    m_lo_bits = other.m_lo_bits;
+    m_lo_mask = other.m_lo_mask;
+  }
+
+  size_t m_size;
+  T m_min;
+  T m_max;
+
+  uint64_t m_lo_bits;
+  uint64_t m_lo_mask = 0;
+
+  stash::bit_vector m_high;
+  stash::int_vector m_low;
+  std::vector<size_t> m_zero_samples;
+  stash::bit_select<1> m_select;
+};
+}  // namespace lce::pred
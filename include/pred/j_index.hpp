@@ -10,6 +10,7 @@
 
 #include <algorithm>
 
+#include "batch_search.hpp"
 #include "pred_result.hpp"
 
 namespace lce::pred {
@@ -122,7 +123,26 @@ class j_index {
     return {true, scan_pos};
   }
 
+  inline void predecessor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<true>(m_data, m_size, m_min, m_max, keys, num, out,
+                       [&](const T x) { return window(x); });
+  }
+
+  inline void successor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<false>(m_data, m_size, m_min, m_max, keys, num, out,
+                        [&](const T x) { return window(x); });
+  }
+
  private:
+  inline std::pair<size_t, size_t> window(const T x) const {
+    int64_t aprx_pos = (1.0 * x) / slope;
+    int64_t left_border = std::max(aprx_pos + max_l_error, int64_t{0});
+    int64_t right_border =
+        std::min(aprx_pos + max_r_error + 1, static_cast<int64_t>(m_size));
+    return {static_cast<size_t>(left_border),
+            static_cast<size_t>(right_border)};
+  }
+
   const T* m_data;
   size_t m_size;
   T m_min;
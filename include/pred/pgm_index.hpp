@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <pgm_index.hpp>
 
+#include "batch_search.hpp"
 #include "pred_result.hpp"
 
 namespace lce::pred {
@@ -72,7 +73,22 @@ class pgm_index {
     // just outside the interval!
   }
 
+  inline void predecessor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<true>(m_data, m_num, m_min, m_max, keys, num, out,
+                       [&](const T x) { return window(x); });
+  }
+
+  inline void successor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<false>(m_data, m_num, m_min, m_max, keys, num, out,
+                        [&](const T x) { return window(x); });
+  }
+
  private:
+  inline std::pair<size_t, size_t> window(const T x) const {
+    auto range = m_pgm.search(x);
+    return {range.lo, range.hi};
+  }
+
   const T* m_data;
   size_t m_num;
   T m_min;
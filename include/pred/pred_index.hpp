@@ -12,30 +12,46 @@
 #include <omp.h>
 
 #include <algorithm>
+#include <limits>
 
+#include "../util/memory_breakdown.hpp"
+#include "batch_search.hpp"
 #include "pred_result.hpp"
 
 namespace lce::pred {
 
+// The value of t_lo_bits for a number of low bits that is passed to the
+// constructor.
+inline constexpr size_t dynamic_lo_bits = std::numeric_limits<size_t>::max();
+
 // the "idx" data structure for successor queries
-template <typename T, size_t m_lo_bits, typename index_type>
+template <typename T, size_t t_lo_bits, typename index_type>
 class pred_index {
  public:
   typedef T data_type;
-  inline pred_index() : m_data(nullptr), m_size(0), m_min(0), m_max(0) {
+  inline pred_index()
+      : m_data(nullptr), m_size(0), m_min(0), m_max(0), m_lo_bits(t_lo_bits) {
   }
 
+  // lo_bits must only be given if t_lo_bits is dynamic_lo_bits.
   template <typename C>
-  pred_index(C const& container)
-      : pred_index(container.data(), container.size()) {
+    requires requires(C const& c) { c.data(); }
+  pred_index(C const& container, size_t lo_bits = t_lo_bits)
+      : pred_index(container.data(), container.size(), lo_bits) {
   }
 
-  inline pred_index(T const* data, size_t size)
-      : m_data(data), m_size(size), m_min(data[0]), m_max(data[size - 1]) {
+  inline pred_index(T const* data, size_t size, size_t lo_bits = t_lo_bits)
+      : m_data(data),
+        m_size(size),
+        m_min(data[0]),
+        m_max(data[size - 1]),
+        m_lo_bits(lo_bits) {
     assert(std::is_sorted(m_data, m_data + size));
+    assert(lo_bits == t_lo_bits || t_lo_bits == dynamic_lo_bits);
+    assert(lo_bits < 64);
 
     // build an index for high bits
-    m_hi_idx.resize((uint64_t(m_max) >> m_lo_bits) + 2);
+    m_hi_idx.resize((uint64_t(m_max) >> this->lo_bits()) + 2);
 #pragma omp parallel
     {
       const int t = omp_get_thread_num();
@@ -62,16 +78,23 @@ class pred_index {
   }
 
  private:
-  static constexpr size_t m_hi_bits = 8 * sizeof(T) - m_lo_bits;
+  inline size_t lo_bits() const {
+    if constexpr (t_lo_bits != dynamic_lo_bits) {
+      return t_lo_bits;
+    } else {
+      return m_lo_bits;
+    }
+  }
 
-  static constexpr uint64_t hi(uint64_t x) {
-    return x >> m_lo_bits;
+  inline uint64_t hi(uint64_t x) const {
+    return x >> lo_bits();
   }
 
   const T* m_data;
   size_t m_size;
   T m_min;
   T m_max;
+  size_t m_lo_bits;
 
   std::vector<index_type> m_hi_idx;
 
@@ -104,5 +127,32 @@ class pred_index {
     return {true, static_cast<size_t>(std::distance(
                       m_data, std::lower_bound(m_data + p, m_data + q, x)))};
   }
+
+  size_t size_in_bytes() const {
+    return m_hi_idx.size() * sizeof(index_type);
+  }
+
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem;
+    mem.add("hi_index", m_hi_idx);
+    return mem;
+  }
+
+  inline void predecessor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<true>(m_data, m_size, m_min, m_max, keys, num, out,
+                       [&](const T x) { return window(x); });
+  }
+
+  inline void successor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<false>(m_data, m_size, m_min, m_max, keys, num, out,
+                        [&](const T x) { return window(x); });
+  }
+
+ private:
+  inline std::pair<size_t, size_t> window(const T x) const {
+    const uint64_t key = hi(x);
+    __builtin_prefetch(m_hi_idx.data() + key);
+    return {m_hi_idx[key], m_hi_idx[key + 1]};
+  }
 };
 }  // namespace lce::pred
\ No newline at end of file
@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * lce/pred/radix_spline_index.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "batch_search.hpp"
+#include "pred_result.hpp"
+
+namespace lce::pred {
+
+// RadixSpline (Kipf et al.): a linear spline through some of the (key,
+// position) pairs of the data, such that interpolating any key is at most
+// t_max_error positions off. The spline points are found with a greedy
+// corridor in a single pass. A radix table on the t_radix_bits highest bits
+// of a key narrows down the spline segment. Unlike j_index, the error bound is
+// local, so varying density (e.g. runs in the sss) doesn't widen the search.
+template <typename T, uint64_t t_max_error = 32, uint64_t t_radix_bits = 18>
+class radix_spline_index {
+ public:
+  typedef T data_type;
+
+  inline radix_spline_index()
+      : m_data(nullptr), m_size(0), m_min(0), m_max(0), m_shift(0) {
+  }
+
+  template <typename C>
+  radix_spline_index(C const& container)
+      : radix_spline_index(container.data(), container.size()) {
+  }
+
+  inline radix_spline_index(T const* data, size_t size)
+      : m_data(data), m_size(size), m_min(data[0]), m_max(data[size - 1]) {
+    assert(std::is_sorted(data, data + size));
+
+    // every thread builds the spline of a slice, the segment between two
+    // slices connects neighbouring positions and is exact
+    std::vector<std::vector<std::pair<uint64_t, uint64_t>>> points(
+        omp_get_max_threads());
+#pragma omp parallel
+    {
+      const int t = omp_get_thread_num();
+      const int nt = omp_get_num_threads();
+      const size_t slice_size = m_size / nt;
+      const size_t begin = t * slice_size;
+      const size_t end = (t < nt - 1) ? (t + 1) * slice_size : m_size;
+
+      if (begin < end) {
+        build_spline(begin, end, points[t]);
+      }
+    }
+    for (auto const& thread_points : points) {
+      for (auto const& [key, pos] : thread_points) {
+        m_spline_keys.push_back(key);
+        m_spline_pos.push_back(pos);
+      }
+    }
+
+    // radix table: entry p is the first spline point whose prefix is >= p
+    const uint64_t key_bits = std::bit_width(offset(m_max));
+    m_shift = (key_bits > t_radix_bits) ? key_bits - t_radix_bits : 0;
+    m_radix_table.resize((offset(m_max) >> m_shift) + 2);
+    uint64_t prefix = 0;
+    m_radix_table[0] = 0;
+    for (size_t i = 0; i < m_spline_keys.size(); ++i) {
+      const uint64_t cur_prefix = m_spline_keys[i] >> m_shift;
+      for (; prefix < cur_prefix; ++prefix) {
+        m_radix_table[prefix + 1] = i;
+      }
+    }
+    for (; prefix + 1 < m_radix_table.size(); ++prefix) {
+      m_radix_table[prefix + 1] = m_spline_keys.size();
+    }
+  }
+
+  // finds the greatest element less than OR equal to x
+  inline result predecessor(const T x) const {
+    if (x < m_min) [[unlikely]]
+      return result{false, 0};
+    if (x >= m_max) [[unlikely]]
+      return result{true, m_size - 1};
+
+    const auto [p, q] = window(x);
+    return {true, static_cast<size_t>(
+                      std::distance(m_data, std::upper_bound(m_data + p,
+                                                             m_data + q, x)) -
+                      1)};
+  }
+
+  // finds the smallest element greater than OR equal to x
+  inline result successor(const T x) const {
+    if (x <= m_min) [[unlikely]]
+      return result{true, 0};
+    if (x > m_max) [[unlikely]]
+      return result{false, 0};
+
+    const auto [p, q] = window(x);
+    return {true, static_cast<size_t>(std::distance(
+                      m_data, std::lower_bound(m_data + p, m_data + q, x)))};
+  }
+
+  inline void predecessor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<true>(m_data, m_size, m_min, m_max, keys, num, out,
+                       [&](const T x) { return window(x); });
+  }
+
+  inline void successor_batch(T const* keys, size_t num, result* out) const {
+    batch_search<false>(m_data, m_size, m_min, m_max, keys, num, out,
+                        [&](const T x) { return window(x); });
+  }
+
+  size_t num_spline_points() const {
+    return m_spline_keys.size();
+  }
+
+  size_t size_in_bytes() const {
+    return m_spline_keys.size() * sizeof(uint64_t) +
+           m_spline_pos.size() * sizeof(uint64_t) +
+           m_radix_table.size() * sizeof(uint32_t);
+  }
+
+ private:
+  inline uint64_t offset(const T x) const {
+    return uint64_t(x) - uint64_t(m_min);
+  }
+
+  // sign of the cross product of (dx1, dy1) and (dx2, dy2)
+  inline static int orientation(double dx1, double dy1, double dx2,
+                                double dy2) {
+    const double expr = dy1 * dx2 - dy2 * dx1;
+    return (expr > 0) - (expr < 0);
+  }
+
+  // greedy spline corridor over data[begin..end)
+  inline void build_spline(
+      size_t begin, size_t end,
+      std::vector<std::pair<uint64_t, uint64_t>>& points) const {
+    constexpr double error = t_max_error;
+    points.emplace_back(offset(m_data[begin]), begin);
+    if (end - begin == 1) {
+      return;
+    }
+
+    double upper_x = offset(m_data[begin + 1]);
+    double upper_y = begin + 1 + error;
+    double lower_x = upper_x;
+    double lower_y = double(begin + 1) - error;
+    for (size_t i = begin + 2; i < end; ++i) {
+      const uint64_t key = offset(m_data[i]);
+      const double last_x = points.back().first;
+      const double last_y = points.back().second;
+      const double dx = key - last_x;
+      const double dy = i - last_y;
+
+      if (orientation(upper_x - last_x, upper_y - last_y, dx, dy) != 1 ||
+          orientation(lower_x - last_x, lower_y - last_y, dx, dy) != -1) {
+        // the point leaves the corridor, the previous point ends the segment
+        points.emplace_back(offset(m_data[i - 1]), i - 1);
+        upper_x = lower_x = key;
+        upper_y = i + error;
+        lower_y = double(i) - error;
+      } else {
+        // narrow the corridor
+        if (orientation(upper_x - last_x, upper_y - last_y, dx,
+                        i + error - last_y) == 1) {
+          upper_x = key;
+          upper_y = i + error;
+        }
+        if (orientation(lower_x - last_x, lower_y - last_y, dx,
+                        double(i) - error - last_y) == -1) {
+          lower_x = key;
+          lower_y = double(i) - error;
+        }
+      }
+    }
+    points.emplace_back(offset(m_data[end - 1]), end - 1);
+  }
+
+  // Return a range [p, q) of positions that contains the lower and upper
+  // bound of x. Here x must be within [m_min, m_max].
+  inline std::pair<size_t, size_t> window(const T x) const {
+    const uint64_t y = offset(x);
+    const uint64_t prefix = y >> m_shift;
+    const size_t lo = m_radix_table[prefix];
+    const size_t hi =
+        std::min<size_t>(m_radix_table[prefix + 1] + 1, m_spline_keys.size());
+
+    // first spline point not less than y, the segment ends there
+    const size_t idx = std::distance(
+        m_spline_keys.begin(), std::lower_bound(m_spline_keys.begin() + lo,
+                                                m_spline_keys.begin() + hi, y));
+    if (idx == 0) [[unlikely]] {
+      return {0, 1};
+    }
+
+    const double x0 = m_spline_keys[idx - 1];
+    const double y0 = m_spline_pos[idx - 1];
+    const double x1 = m_spline_keys[idx];
+    const double y1 = m_spline_pos[idx];
+    const double estimate = y0 + (y - x0) * (y1 - y0) / (x1 - x0);
+
+    const size_t pos = static_cast<size_t>(estimate);
+    const size_t p = (pos > t_max_error + 1) ? pos - t_max_error - 1 : 0;
+    const size_t q = std::min(pos + t_max_error + 2, m_size);
+    return {p, q};
+  }
+
+  T const* m_data;
+  size_t m_size;
+  T m_min;
+  T m_max;
+
+  uint64_t m_shift;
+  std::vector<uint64_t> m_spline_keys;
+  std::vector<uint64_t> m_spline_pos;
+  std::vector<uint32_t> m_radix_table;
+};
+}  // namespace lce::pred
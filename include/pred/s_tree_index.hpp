@@ -0,0 +1,243 @@
+/*******************************************************************************
+ * lce/pred/s_tree_index.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <immintrin.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "batch_search.hpp"
+#include "pred_result.hpp"
+#include "util/aligned_allocator.hpp"
+
+namespace lce::pred {
+
+// static B+-tree (S+-tree) with 16 keys per node stored layer by layer in one
+// cache line aligned array. The leaf layer holds all keys, an inner node holds
+// the largest key of each of its 16 children. Nodes are searched with AVX2
+// compares instead of branches.
+template <typename T>
+class s_tree_index {
+ public:
+  typedef T data_type;
+  typedef std::conditional_t<sizeof(T) <= 4, uint32_t, uint64_t> key_type;
+  static constexpr size_t m_node_size = 16;
+
+  inline s_tree_index() : m_size(0), m_min(0), m_max(0) {
+  }
+
+  template <typename C>
+  s_tree_index(C const& container)
+      : s_tree_index(container.data(), container.size()) {
+  }
+
+  inline s_tree_index(T const* data, size_t size)
+      : m_size(size), m_min(data[0]), m_max(data[size - 1]) {
+    assert(std::is_sorted(data, data + size));
+
+    // determine the number of nodes per layer (bottom up)
+    std::vector<size_t> layer_nodes{div_ceil(m_size, m_node_size)};
+    while (layer_nodes.back() > 1) {
+      layer_nodes.push_back(div_ceil(layer_nodes.back(), m_node_size));
+    }
+    m_layer_offset.resize(layer_nodes.size() + 1);
+    m_layer_offset[0] = 0;
+    for (size_t h = 0; h < layer_nodes.size(); ++h) {
+      m_layer_offset[h + 1] = m_layer_offset[h] + layer_nodes[h] * m_node_size;
+    }
+    m_height = layer_nodes.size();
+    m_keys.resize(m_layer_offset.back());
+
+    // leaf layer, padded with the largest possible key
+    const size_t leaf_slots = m_layer_offset[1];
+#pragma omp parallel for
+    for (size_t i = 0; i < leaf_slots; ++i) {
+      m_keys[i] = flip(i < m_size ? static_cast<key_type>(uint64_t(data[i]))
+                                  : std::numeric_limits<key_type>::max());
+    }
+
+    // inner layers: the c-th key of a node is the last key of its c-th child
+    for (size_t h = 1; h < m_height; ++h) {
+      key_type* const layer = m_keys.data() + m_layer_offset[h];
+      key_type const* const child_layer = m_keys.data() + m_layer_offset[h - 1];
+      const size_t num_children = layer_nodes[h - 1];
+      const size_t slots = layer_nodes[h] * m_node_size;
+#pragma omp parallel for
+      for (size_t i = 0; i < slots; ++i) {
+        layer[i] = (i < num_children)
+                       ? child_layer[i * m_node_size + m_node_size - 1]
+                       : flip(std::numeric_limits<key_type>::max());
+      }
+    }
+  }
+
+  // finds the greatest element less than OR equal to x
+  inline result predecessor(const T x) const {
+    if (x < m_min) [[unlikely]]
+      return result{false, 0};
+    if (x >= m_max) [[unlikely]]
+      return result{true, m_size - 1};
+
+    // the first key greater than x is the first key not less than x + 1
+    return {true, search(static_cast<key_type>(uint64_t(x)) + 1) - 1};
+  }
+
+  // finds the smallest element greater than OR equal to x
+  inline result successor(const T x) const {
+    if (x <= m_min) [[unlikely]]
+      return result{true, 0};
+    if (x > m_max) [[unlikely]]
+      return result{false, 0};
+
+    return {true, search(static_cast<key_type>(uint64_t(x)))};
+  }
+
+  // no batch_search, the tree is descended by up to batch_group_size keys in
+  // lockstep
+  inline void predecessor_batch(T const* keys, size_t num, result* out) const {
+    search_batch<true>(keys, num, out);
+  }
+
+  inline void successor_batch(T const* keys, size_t num, result* out) const {
+    search_batch<false>(keys, num, out);
+  }
+
+  size_t size_in_bytes() const {
+    return m_keys.size() * sizeof(key_type) +
+           m_layer_offset.size() * sizeof(size_t);
+  }
+
+ private:
+  // keys are stored with a flipped sign bit, which lets us use the signed
+  // AVX2 compares for unsigned keys
+  static constexpr key_type m_sign_bit = key_type{1}
+                                         << (8 * sizeof(key_type) - 1);
+
+  static constexpr key_type flip(key_type x) {
+    return x ^ m_sign_bit;
+  }
+
+  inline static uint64_t div_ceil(uint64_t x, uint64_t y) {
+    return x == 0 ? 0 : (1 + (x - 1) / y);
+  }
+
+  // Return the number of keys in the node that are smaller than x, where x
+  // has already been flipped.
+  inline static uint32_t rank(key_type const* node, const key_type x) {
+#ifdef __AVX2__
+    if constexpr (sizeof(key_type) == 8) {
+      const __m256i x_vec = _mm256_set1_epi64x(static_cast<int64_t>(x));
+      __m256i const* n = reinterpret_cast<__m256i const*>(node);
+      const __m256i lt0 = _mm256_cmpgt_epi64(x_vec, _mm256_load_si256(n));
+      const __m256i lt1 = _mm256_cmpgt_epi64(x_vec, _mm256_load_si256(n + 1));
+      const __m256i lt2 = _mm256_cmpgt_epi64(x_vec, _mm256_load_si256(n + 2));
+      const __m256i lt3 = _mm256_cmpgt_epi64(x_vec, _mm256_load_si256(n + 3));
+      const uint32_t mask =
+          _mm256_movemask_pd(_mm256_castsi256_pd(lt0)) |
+          (_mm256_movemask_pd(_mm256_castsi256_pd(lt1)) << 4) |
+          (_mm256_movemask_pd(_mm256_castsi256_pd(lt2)) << 8) |
+          (_mm256_movemask_pd(_mm256_castsi256_pd(lt3)) << 12);
+      return std::popcount(mask);
+    } else {
+      const __m256i x_vec = _mm256_set1_epi32(static_cast<int32_t>(x));
+      __m256i const* n = reinterpret_cast<__m256i const*>(node);
+      const __m256i lt0 = _mm256_cmpgt_epi32(x_vec, _mm256_load_si256(n));
+      const __m256i lt1 = _mm256_cmpgt_epi32(x_vec, _mm256_load_si256(n + 1));
+      const uint32_t mask =
+          _mm256_movemask_ps(_mm256_castsi256_ps(lt0)) |
+          (_mm256_movemask_ps(_mm256_castsi256_ps(lt1)) << 8);
+      return std::popcount(mask);
+    }
+#else
+    typedef std::make_signed_t<key_type> signed_key_type;
+    uint32_t r = 0;
+    for (size_t i = 0; i < m_node_size; ++i) {
+      r += static_cast<signed_key_type>(node[i]) <
+           static_cast<signed_key_type>(x);
+    }
+    return r;
+#endif
+  }
+
+  // Return the position of the first key not less than x. There must be such
+  // a key.
+  inline size_t search(key_type x) const {
+    x = flip(x);
+    key_type const* const keys = m_keys.data();
+    size_t node = 0;
+    for (size_t h = m_height - 1; h > 0; --h) {
+      node = node * m_node_size +
+             rank(keys + m_layer_offset[h] + node * m_node_size, x);
+    }
+    return node * m_node_size + rank(keys + node * m_node_size, x);
+  }
+
+  template <bool t_pred>
+  inline void search_batch(T const* keys, size_t num, result* out) const {
+    key_type x[batch_group_size];
+    size_t node[batch_group_size];
+    bool in_range[batch_group_size];
+    result res[batch_group_size];
+    key_type const* const tree = m_keys.data();
+
+    for (size_t g = 0; g < num; g += batch_group_size) {
+      const size_t group = std::min(batch_group_size, num - g);
+      for (size_t i = 0; i < group; ++i) {
+        const T key = keys[g + i];
+        if constexpr (t_pred) {
+          in_range[i] = key >= m_min && key < m_max;
+          res[i] = {key >= m_min, key >= m_max ? m_size - 1 : 0};
+          x[i] = static_cast<key_type>(uint64_t(key)) + 1;
+        } else {
+          in_range[i] = key > m_min && key <= m_max;
+          res[i] = {key <= m_max, 0};
+          x[i] = static_cast<key_type>(uint64_t(key));
+        }
+        // keys out of range descend along the leftmost path
+        x[i] = flip(in_range[i] ? x[i] : 0);
+        node[i] = 0;
+      }
+
+      for (size_t h = m_height - 1; h > 0; --h) {
+        key_type const* const layer = tree + m_layer_offset[h];
+        for (size_t i = 0; i < group; ++i) {
+          node[i] = node[i] * m_node_size +
+                    rank(layer + node[i] * m_node_size, x[i]);
+          __builtin_prefetch(tree + m_layer_offset[h - 1] +
+                             node[i] * m_node_size);
+        }
+      }
+
+      for (size_t i = 0; i < group; ++i) {
+        if (in_range[i]) {
+          const size_t pos =
+              node[i] * m_node_size + rank(tree + node[i] * m_node_size, x[i]);
+          res[i] = {true, t_pred ? pos - 1 : pos};
+        }
+      }
+      std::copy_n(res, group, out + g);
+    }
+  }
+
+  size_t m_size;
+  T m_min;
+  T m_max;
+
+  size_t m_height = 0;
+  std::vector<size_t> m_layer_offset;
+  std::vector<key_type, lce::util::aligned_allocator<key_type>> m_keys;
+};
+}  // namespace lce::pred
@@ -108,6 +108,14 @@ class rmq_n {
     return rmq_lr(left, right);
   }
 
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem;
+    mem.add("rmq_samples", m_sampled_indexes);
+    mem.add("rmq_samples", m_sampled_minimas);
+    mem.add(m_sampled_rmq.memory_breakdown());
+    return mem;
+  }
+
  private:
   key_type const* m_data = nullptr;
   size_t m_size;
@@ -13,6 +13,8 @@
 
 #include <vector>
 
+#include "../util/memory_breakdown.hpp"
+
 namespace lce::rmq {
 
 template <typename t_key_type, typename index_type = uint32_t>
@@ -114,6 +116,14 @@ class rmq_nlgn {
                                                             : r_interval_min;
   }
 
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem;
+    for (auto const& level : m_power_rmq) {
+      mem.add("rmq_levels", level);
+    }
+    return mem;
+  }
+
  private:
   key_type const* m_data = nullptr;
   std::vector<std::vector<index_type>> m_power_rmq;
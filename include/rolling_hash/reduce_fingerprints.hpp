@@ -21,6 +21,9 @@
 #include <fmt/ranges.h>
 
 #include "util/timer.hpp"
+#ifdef LCE_BENCHMARK_PERF
+#include "util/perf_counters.hpp"
+#endif
 #ifdef LCE_BENCHMARK_SPACE
 #include <malloc_count/malloc_count.h>
 #endif
@@ -28,27 +31,36 @@
 
 namespace lce::ds {
 
-template <typename sss_type>
-bool leq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
+template <typename sss_type, typename t_text>
+bool leq_three_tau(t_text const& text, size_t text_size, size_t text_pos_i,
                    size_t text_pos_j, sss_type const& sync_set);
-template <typename sss_type>
-bool eq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
+template <typename sss_type, typename t_text>
+bool eq_three_tau(t_text const& text, size_t text_size, size_t text_pos_i,
                   size_t text_pos_j, sss_type const& sync_set);
 
-template <typename sss_type>
+// The text is either a uint8_t const* or a util::reversed_text<uint8_t>, which
+// reads the original buffer from right to left.
+template <typename sss_type, typename t_text>
 std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
-    uint8_t const* text, size_t text_size, sss_type const& sync_set) {
+    t_text const& text, size_t text_size, sss_type const& sync_set) {
   using index_type = sss_type::index_type;
-  static constexpr uint64_t tau = sss_type::tau;
+  const uint64_t tau = sync_set.get_tau();
 
   __extension__ typedef unsigned __int128 uint128_t;
   std::vector<index_type> const& sss = sync_set.get_sss();
 
+#ifdef LCE_BENCHMARK_INTERNAL
+  lce::util::timer t;
+#ifdef LCE_BENCHMARK_PERF
+  lce::util::perf_counters perf;
+#endif
+#endif
+
   // sort sss-pos by 3tau-infix
   std::vector<index_type> sss_sorted = sss;
   ips4o::parallel::sort(
       sss_sorted.begin(), sss_sorted.end(),
-      [&text, &text_size, &sync_set](index_type lhs, index_type rhs) {
+      [&text, &text_size, &sync_set, tau](index_type lhs, index_type rhs) {
         if (lhs == rhs) {
           return false;
         }
@@ -67,6 +79,12 @@ std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
         }
         return false;
       });
+#ifdef LCE_BENCHMARK_INTERNAL
+  fmt::print(" reduce_sort_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+  perf.print_and_reset("reduce_sort");
+#endif
+#endif
 
   for (size_t idx = 1; idx < sss_sorted.size(); ++idx) {
     size_t i = sss_sorted[idx - 1];
@@ -135,6 +153,13 @@ std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
     }
   }
 
+#ifdef LCE_BENCHMARK_INTERNAL
+  fmt::print(" reduce_rank_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+  perf.print_and_reset("reduce_rank");
+#endif
+#endif
+
   // Check rank_tuples
   {
     assert(rank_tuples.size() == sss_sorted.size());
@@ -160,15 +185,21 @@ std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
     fps_reduced[i] = rank_tuples[i].rank;
   }
   // fps.push_back(0) // If using SAIS
+#ifdef LCE_BENCHMARK_INTERNAL
+  fmt::print(" reduce_reorder_time={}", t.get_and_reset());
+#ifdef LCE_BENCHMARK_PERF
+  perf.print_and_reset("reduce_reorder");
+#endif
+#endif
   return fps_reduced;
 }
 
-template <typename sss_type>
-bool leq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
+template <typename sss_type, typename t_text>
+bool leq_three_tau(t_text const& text, size_t text_size, size_t text_pos_i,
                    size_t text_pos_j, sss_type const& sync_set) {
-  constexpr size_t tau = sync_set.tau;
+  const size_t tau = sync_set.get_tau();
   size_t const max_length = std::min(
-      {text_size - text_pos_i, text_size - text_pos_j, 3 * sync_set.tau});
+      {text_size - text_pos_i, text_size - text_pos_j, 3 * tau});
   size_t text_lce = lce_naive_wordwise_xor<uint8_t>::lce_up_to(
       text, text_size, text_pos_i, text_pos_j, 3 * tau);
   return (text_lce < max_length &&
@@ -177,12 +208,12 @@ bool leq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
                                         sync_set.get_run_info(text_pos_j));
 }
 
-template <typename sss_type>
-bool eq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
+template <typename sss_type, typename t_text>
+bool eq_three_tau(t_text const& text, size_t text_size, size_t text_pos_i,
                   size_t text_pos_j, sss_type const& sync_set) {
   assert(text_pos_i != text_pos_j);
   size_t lce = lce_naive_wordwise_xor<uint8_t>::lce_up_to(
-      text, text_size, text_pos_i, text_pos_j, 3 * sync_set.tau);
+      text, text_size, text_pos_i, text_pos_j, 3 * sync_set.get_tau());
 
   if (std::max(text_pos_i, text_pos_j) + lce == text_size) {
     return false;
@@ -11,31 +11,90 @@
 #include <omp.h>
 #include <parallel_hashmap/phmap.h>
 
+#include <algorithm>
 #include <mutex>
+#include <type_traits>
 
+#include "../util/memory_breakdown.hpp"
+#include "../util/reversed_text.hpp"
 #include "ring_buffer.hpp"
 #include "rolling_hash.hpp"
 namespace lce::rolling_hash {
 
+// The value of t_tau for a tau that is passed to the constructor.
+inline constexpr uint64_t dynamic_tau = 0;
+
+// If t_tau is dynamic_tau, tau is chosen at runtime. The scans over the
+// windows are still specialised for the common values of tau (see with_tau).
 template <typename t_index = uint32_t, uint64_t t_tau = 1024>
 class sss {
  public:
   typedef t_index index_type;
+  // dynamic_tau if tau is chosen at runtime, see get_tau()
   static constexpr uint64_t tau = t_tau;
   __extension__ typedef unsigned __int128 uint128_t;
 
-  sss() : m_fps_calculated(false) {
+  // The periodic area text[start, end) with period period < tau / 4 (not
+  // necessarily the smallest) found by calculate_q. Areas that cross the
+  // slices of two threads may be split.
+  struct periodic_region {
+    t_index start;
+    t_index end;
+    t_index period;
+  };
+
+  sss() : m_fps_calculated(false), m_tau(t_tau) {
   }
 
+  // tau must only be given if t_tau is dynamic_tau.
   template <typename t_char_type>
-  sss(t_char_type const* text, size_t size, bool calculate_fps = false)
-      : m_fps_calculated(calculate_fps) {
-    assert(size > 5 * t_tau);
+  sss(t_char_type const* text, size_t size, bool calculate_fps = false,
+      uint64_t tau = t_tau)
+      : m_fps_calculated(calculate_fps), m_tau(tau) {
+    build(text, size);
+  }
+
+  // The synchronizing set of the reversed text, read from the original buffer.
+  template <typename t_char_type>
+  sss(util::reversed_text<t_char_type> const& text, size_t size,
+      bool calculate_fps = false, uint64_t tau = t_tau)
+      : m_fps_calculated(calculate_fps), m_tau(tau) {
+    build(text, size);
+  }
+
+  // Return a synchronizing set of the reversed text without another pass over
+  // it. Whether i is synchronizing only depends on where the minimum of the
+  // fingerprints of the tau + 1 windows in text[i, i + 2 * tau) lies. These
+  // are the reversed windows at position size - 2 * tau - i of the reversed
+  // text, but their fingerprints differ, so the result is not the set that is
+  // built on the reversed text, but a valid one for the hash
+  // w -> fp(reverse(w)). This is only possible if there are no runs (their run
+  // information depends on the direction) and without fingerprints.
+  static sss mirrored(sss const& other, size_t size) {
+    assert(!other.has_runs() && !other.fps_calculated());
+    sss result;
+    result.m_runs_detected = false;
+    result.m_tau = other.m_tau;
+    const uint64_t tau = other.get_tau();
+    const size_t num = other.m_sss.size();
+    result.m_sss.resize(num);
+#pragma omp parallel for
+    for (size_t k = 0; k < num; ++k) {
+      result.m_sss[k] = size - 2 * tau - other.m_sss[num - 1 - k];
+    }
+    return result;
+  }
+
+  template <typename t_text>
+  void build(t_text const& text, size_t size) {
+    const uint64_t tau = get_tau();
+    assert(tau == t_tau || t_tau == dynamic_tau);
+    assert(tau != dynamic_tau && size > 5 * tau);
     std::vector<std::vector<t_index>> sss_part(omp_get_max_threads());
     std::vector<std::vector<uint128_t>> fps_part(omp_get_max_threads());
 #pragma omp parallel
     {
-      const size_t sss_end = size - 2 * t_tau + 1;
+      const size_t sss_end = size - 2 * tau + 1;
 
       const int t = omp_get_thread_num();
       const int nt = omp_get_num_threads();
@@ -44,8 +103,9 @@ class sss {
       const size_t begin = t * slice_size;
       const size_t end = (t < nt - 1) ? (t + 1) * slice_size : sss_end;
 
-      std::tie(sss_part[t], fps_part[t]) =
-          fill_synchronizing_set(text, begin, end);
+      std::tie(sss_part[t], fps_part[t]) = with_tau([&](auto fixed_tau) {
+        return fill_synchronizing_set(text, begin, end, fixed_tau);
+      });
     }
 
     // Merge SSS parts
@@ -54,14 +114,16 @@ class sss {
       write_pos.push_back(write_pos.back() + part.size());
     }
     size_t sss_size = write_pos.back();
-    m_runs_detected = sss_size > size * 4 / t_tau;
+    m_runs_detected = sss_size > size * 4 / tau;
 
     // If the text contains long runs, the sss inflates. We the then use a
     // algorithm which detects runs.
     if (m_runs_detected) {
+      std::vector<std::vector<periodic_region>> regions_part(
+          omp_get_max_threads());
 #pragma omp parallel
       {
-        const size_t sss_end = size - 2 * t_tau + 1;
+        const size_t sss_end = size - 2 * tau + 1;
 
         const int t = omp_get_thread_num();
         const int nt = omp_get_num_threads();
@@ -70,9 +132,19 @@ class sss {
         const size_t begin = t * slice_size;
         const size_t end = (t < nt - 1) ? (t + 1) * slice_size : sss_end;
         sss_part[t] = std::vector<t_index>{};
-        std::tie(sss_part[t], fps_part[t]) =
-            fill_synchronizing_set_runs(text, size, begin, end);
+        std::tie(sss_part[t], fps_part[t]) = with_tau([&](auto fixed_tau) {
+          return fill_synchronizing_set_runs(text, size, begin, end,
+                                             regions_part[t], fixed_tau);
+        });
       }
+      for (auto const& part : regions_part) {
+        m_periodic_regions.insert(m_periodic_regions.end(), part.begin(),
+                                  part.end());
+      }
+      std::sort(m_periodic_regions.begin(), m_periodic_regions.end(),
+                [](periodic_region const& a, periodic_region const& b) {
+                  return a.start < b.start;
+                });
       write_pos = {0};
       for (auto& part : sss_part) {
         write_pos.push_back(write_pos.back() + part.size());
@@ -100,7 +172,7 @@ class sss {
           size_t prev_i = m_sss[write_pos[t] - 1];
           size_t distance = i - prev_i;
           assert(distance < (size_t{1} << 20));
-          if (distance > t_tau) {
+          if (distance > tau) {
             m_fps[write_pos[t] - 1] += (uint128_t{distance} << 107);
           }
         }
@@ -108,60 +180,60 @@ class sss {
     }
     if (m_runs_detected) {
       m_sss.back() =
-          size - 2 * t_tau + 1;  // sentinel needed for text with runs
+          size - 2 * tau + 1;  // sentinel needed for text with runs
       if (m_fps_calculated) {
         m_fps.back() = 1;
       }
     }
   }
 
-  template <typename t_char_type>
+  template <typename t_text, typename t_tau_value>
   std::pair<std::vector<t_index>, std::vector<uint128_t>>
-  fill_synchronizing_set(t_char_type const* text, const size_t from,
-                         const size_t to) const {
+  fill_synchronizing_set(t_text const& text, const size_t from,
+                         const size_t to, const t_tau_value tau) const {
     // calculate SSS
     std::vector<t_index> sss;
     std::vector<uint128_t> fps;
 
-    rk_prime rk(t_tau, 296819);
-    rk_prime rk3(3 * t_tau, 296819);
+    rk_prime rk(tau, 296819);
+    rk_prime rk3(3 * tau, 296819);
 
-    for (size_t i = 0; i < t_tau; ++i) {
+    for (size_t i = 0; i < tau; ++i) {
       rk.roll_in(text[from + i]);
     }
-    for (size_t i = 0; i < 3 * t_tau; ++i) {
+    for (size_t i = 0; i < 3 * tau; ++i) {
       rk3.roll_in(text[from + i]);
     }
 
-    ring_buffer<uint128_t> fingerprints(4 * t_tau);
+    ring_buffer<uint128_t> fingerprints(4 * tau);
     fingerprints.resize(from);
     fingerprints.push_back(rk.get_fp());
 
-    ring_buffer<uint128_t> fingerprints3(4 * t_tau);
+    ring_buffer<uint128_t> fingerprints3(4 * tau);
     fingerprints3.resize(from);
     fingerprints3.push_back(rk3.get_fp());
 
     // Loop:
     t_index first_min = 0;
     for (size_t i = from; i < to; ++i) {
-      for (size_t j = fingerprints.size(); j <= i + 3 * t_tau; ++j) {
-        fingerprints.push_back(rk.roll(text[j - 1], text[j + t_tau - 1]));
-        fingerprints3.push_back(rk3.roll(text[j - 1], text[j + 3 * t_tau - 1]));
+      for (size_t j = fingerprints.size(); j <= i + 3 * tau; ++j) {
+        fingerprints.push_back(rk.roll(text[j - 1], text[j + tau - 1]));
+        fingerprints3.push_back(rk3.roll(text[j - 1], text[j + 3 * tau - 1]));
       }
 
       if (first_min == 0 || first_min < i) {
         first_min = i;
-        for (size_t j = i; j <= i + t_tau; ++j) {
+        for (size_t j = i; j <= i + tau; ++j) {
           if (fingerprints[j] < fingerprints[first_min]) {
             first_min = j;
           }
         }
-      } else if (fingerprints[i + t_tau] < fingerprints[first_min]) {
-        first_min = i + t_tau;
+      } else if (fingerprints[i + tau] < fingerprints[first_min]) {
+        first_min = i + tau;
       }
 
       if (fingerprints[first_min] == fingerprints[i] ||
-          fingerprints[first_min] == fingerprints[i + t_tau]) {
+          fingerprints[first_min] == fingerprints[i + tau]) {
         sss.push_back(i);
         if (m_fps_calculated) {
           fps.push_back(fingerprints3[i]);
@@ -170,13 +242,15 @@ class sss {
     }
     return {sss, fps};
   }
-  template <typename t_char_type>
+  template <typename t_text, typename t_tau_value>
   std::pair<std::vector<t_index>, std::vector<uint128_t>>
-  fill_synchronizing_set_runs(const t_char_type* text, size_t size,
-                              const size_t from, const size_t to) {
+  fill_synchronizing_set_runs(t_text const& text, size_t size,
+                              const size_t from, const size_t to,
+                              std::vector<periodic_region>& regions,
+                              const t_tau_value tau) {
     // calculate Q
     std::vector<std::pair<t_index, t_index>> qset =
-        calculate_q(text, size, from, to);
+        calculate_q(text, size, from, to, regions, tau);
     qset.push_back(std::make_pair(std::numeric_limits<t_index>::max(),
                                   std::numeric_limits<t_index>::max()));
     auto it_q = qset.begin();
@@ -185,20 +259,20 @@ class sss {
     std::vector<t_index> sss;
     std::vector<uint128_t> fps;
 
-    rk_prime rk(t_tau, 296819);
-    rk_prime rk3(3 * t_tau, 296819);
-    for (size_t i = 0; i < t_tau; ++i) {
+    rk_prime rk(tau, 296819);
+    rk_prime rk3(3 * tau, 296819);
+    for (size_t i = 0; i < tau; ++i) {
       rk.roll_in(text[from + i]);
     }
-    for (size_t i = 0; i < 3 * t_tau; ++i) {
+    for (size_t i = 0; i < 3 * tau; ++i) {
       rk3.roll_in(text[from + i]);
     }
 
-    ring_buffer<uint128_t> fingerprints(4 * t_tau);
+    ring_buffer<uint128_t> fingerprints(4 * tau);
     fingerprints.resize(from);
     fingerprints.push_back(rk.get_fp());
 
-    ring_buffer<uint128_t> fingerprints3(4 * t_tau);
+    ring_buffer<uint128_t> fingerprints3(4 * tau);
     fingerprints3.resize(from);
     fingerprints3.push_back(rk3.get_fp());
 
@@ -206,9 +280,9 @@ class sss {
     t_index first_min = MIN_UNKNOWN;
     // Loop:
     for (size_t i = from; i < to; ++i) {
-      for (size_t j = fingerprints.size(); j <= i + t_tau; ++j) {
-        fingerprints.push_back(rk.roll(text[j - 1], text[j + t_tau - 1]));
-        fingerprints3.push_back(rk3.roll(text[j - 1], text[j + 3 * t_tau - 1]));
+      for (size_t j = fingerprints.size(); j <= i + tau; ++j) {
+        fingerprints.push_back(rk.roll(text[j - 1], text[j + tau - 1]));
+        fingerprints3.push_back(rk3.roll(text[j - 1], text[j + 3 * tau - 1]));
       }
       while (it_q->second < i) {
         std::advance(it_q, 1);
@@ -217,7 +291,7 @@ class sss {
       // If then minimum in the current range is not known, we need to find one
       if (first_min == MIN_UNKNOWN || first_min < i) {
         auto it_qt = it_q;
-        for (size_t j = i; j <= i + t_tau; ++j) {
+        for (size_t j = i; j <= i + tau; ++j) {
           // advance q pointer
           if (it_qt->second < j) {
             std::advance(it_qt, 1);
@@ -241,25 +315,25 @@ class sss {
         // If no minimum exists, we jump to the next position, which may be part
         // of sss
         if (first_min == MIN_UNKNOWN || first_min < i) {
-          i = it_qt->second - t_tau;
+          i = it_qt->second - tau;
           continue;
         }
       }
       // If the minimum of the range is already known, we only need to compare
       // with the new fingerprint
-      else if (first_min <= i + t_tau) {
+      else if (first_min <= i + tau) {
         auto it_qt = it_q;
-        while (it_qt->second < i + t_tau) {
+        while (it_qt->second < i + tau) {
           std::advance(it_qt, 1);
         }
-        if (it_qt->first > i + t_tau &&
-            fingerprints[i + t_tau] < fingerprints[first_min]) {
-          first_min = i + t_tau;
+        if (it_qt->first > i + tau &&
+            fingerprints[i + tau] < fingerprints[first_min]) {
+          first_min = i + tau;
         }
       }
       // maybe_add(i);
       if (fingerprints[first_min] == fingerprints[i] ||
-          fingerprints[first_min] == fingerprints[i + t_tau]) {
+          fingerprints[first_min] == fingerprints[i + tau]) {
         sss.push_back(i);
         if (m_fps_calculated) {
           fps.push_back(fingerprints3[i]);
@@ -269,7 +343,7 @@ class sss {
             size_t distance = i - prev_i;
             // we only have 20 empty bits in fingerprint
             assert(distance < (size_t{1} << 20));
-            if (distance > t_tau) {
+            if (distance > tau) {
               fps[sss.size() - 2] += (uint128_t{distance} << 107);
             }
           }
@@ -280,25 +354,24 @@ class sss {
     return {sss, fps};
   }
 
-  template <typename t_char_type>
-  std::vector<std::pair<t_index, t_index>> calculate_q(t_char_type* const text,
-                                                       size_t size,
-                                                       const size_t from,
-                                                       const size_t to) {
+  template <typename t_text, typename t_tau_value>
+  std::vector<std::pair<t_index, t_index>> calculate_q(
+      t_text const& text, size_t size, const size_t from, const size_t to,
+      std::vector<periodic_region>& regions, const t_tau_value tau) {
     std::vector<std::pair<t_index, t_index>> qset{};  // inclusive intervals
-    constexpr size_t small_tau = t_tau / 4;
+    const size_t small_tau = tau / 4;
 
     rk_prime rk(small_tau, 296819);
     for (size_t i = 0; i < small_tau; ++i) {
       rk.roll_in(text[from + i]);
     }
 
-    ring_buffer<uint128_t> fingerprints(4 * t_tau);
+    ring_buffer<uint128_t> fingerprints(4 * tau);
     fingerprints.resize(from);
     fingerprints.push_back(rk.get_fp());
 
-    for (size_t i = from; i < to + t_tau; ++i) {  //++i correct?
-      for (size_t j = fingerprints.size(); j < i + t_tau; ++j) {
+    for (size_t i = from; i < to + tau; ++i) {  //++i correct?
+      for (size_t j = fingerprints.size(); j < i + tau; ++j) {
         fingerprints.push_back(rk.roll(text[j - 1], text[j + small_tau - 1]));
       }
       // find first minimum
@@ -331,18 +404,20 @@ class sss {
 
         // extend run naivly to the right
         size_t run_end = next_min;  // inclusive
-        // while (run_end < to + 2 * t_tau - 2 &&
+        // while (run_end < to + 2 * tau - 2 &&
         while (run_end < (size - 1) &&
                text[run_end + 1] == text[run_end - period + 1]) {
           ++run_end;
         }
 
         // add run to set q
-        if (run_end - run_start + 1 >= t_tau) {
-          qset.push_back(std::make_pair(run_start, run_end - t_tau + 1));
+        if (run_end - run_start + 1 >= tau) {
+          qset.push_back(std::make_pair(run_start, run_end - tau + 1));
+          regions.push_back({t_index(run_start), t_index(run_end + 1),
+                             t_index(period)});
           i = run_end - small_tau;
 
-          if (run_end - run_start + 1 >= 3 * t_tau - 1) {
+          if (run_end - run_start + 1 >= 3 * tau - 1) {
             if (run_start == 0) {
               continue;  // Run starts at 0, no run information needed
             }
@@ -356,7 +431,7 @@ class sss {
             }
 
             size_t const sss_pos1 = run_start - 1;
-            size_t const sss_pos2 = run_end - (2 * t_tau) + 2;
+            size_t const sss_pos2 = run_end - (2 * tau) + 2;
             int64_t const run_info = int64_t{1} * size - sss_pos2 + sss_pos1;
             m_run_info[sss_pos1] =
                 text[run_end + 1] > text[run_end - period + 1]
@@ -372,8 +447,17 @@ class sss {
   }
 
   template <typename C>
-  sss(C const& container, bool calculate_fps = false)
-      : sss(container.data(), container.size(), calculate_fps) {
+    requires requires(C const& c) { c.data(); }
+  sss(C const& container, bool calculate_fps = false, uint64_t tau = t_tau)
+      : sss(container.data(), container.size(), calculate_fps, tau) {
+  }
+
+  uint64_t get_tau() const {
+    if constexpr (t_tau != dynamic_tau) {
+      return t_tau;
+    } else {
+      return m_tau;
+    }
   }
 
   bool fps_calculated() const {
@@ -392,6 +476,10 @@ class sss {
     m_fps = std::vector<uint128_t>{};
     m_fps_calculated = false;
   }
+  // frees the positions, e.g. if a compressed copy of them is kept elsewhere
+  void free_sss() {
+    m_sss = std::vector<t_index>{};
+  }
 
   size_t num_runs() const {
     return m_run_info.size();
@@ -400,6 +488,11 @@ class sss {
     return m_runs_detected;
   }
 
+  // The periodic areas sorted by start, empty unless runs were detected.
+  std::vector<periodic_region> const& periodic_regions() const {
+    return m_periodic_regions;
+  }
+
   size_t size() const {
     return m_sss.size();
   }
@@ -408,12 +501,47 @@ class sss {
     return m_sss[i];
   }
 
+  // the run info map is estimated from its number of slots
+  util::memory_breakdown memory_breakdown() const {
+    util::memory_breakdown mem;
+    mem.add("sss", m_sss);
+    mem.add("fps", m_fps);
+    mem.add("periodic_regions", m_periodic_regions);
+    mem.add("run_info",
+            m_run_info.bucket_count() *
+                (sizeof(typename decltype(m_run_info)::value_type) + 1));
+    return mem;
+  }
+
   int64_t get_run_info(size_t pos) const {
     auto run_info_entry = m_run_info.find(pos);
     return run_info_entry == m_run_info.end() ? 0 : run_info_entry->second;
   }
 
  private:
+  // Call f with tau as a std::integral_constant if it is t_tau or one of the
+  // common values, so that the scans over the windows are compiled for it,
+  // and with the runtime value otherwise.
+  template <typename F>
+  decltype(auto) with_tau(F&& f) const {
+    if constexpr (t_tau != dynamic_tau) {
+      return f(std::integral_constant<uint64_t, t_tau>{});
+    } else {
+      switch (m_tau) {
+        case 256:
+          return f(std::integral_constant<uint64_t, 256>{});
+        case 512:
+          return f(std::integral_constant<uint64_t, 512>{});
+        case 1024:
+          return f(std::integral_constant<uint64_t, 1024>{});
+        case 2048:
+          return f(std::integral_constant<uint64_t, 2048>{});
+        default:
+          return f(m_tau);
+      }
+    }
+  }
+
   std::vector<t_index> m_sss;
   std::vector<uint128_t> m_fps;
   bool m_fps_calculated;
@@ -424,5 +552,7 @@ class sss {
       phmap::priv::Allocator<std::pair<const t_index, int64_t>>, 4, std::mutex>
       m_run_info;
   bool m_runs_detected;
+  std::vector<periodic_region> m_periodic_regions;
+  uint64_t m_tau;
 };
 }  // namespace lce::rolling_hash
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * lce/util/aligned_allocator.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace lce::util {
+
+// allocator that places the first element at a multiple of t_alignment, e.g.
+// to let nodes of a search tree start at a cache line
+template <typename T, size_t t_alignment = 64>
+struct aligned_allocator {
+  typedef T value_type;
+
+  aligned_allocator() = default;
+
+  template <typename U>
+  aligned_allocator(aligned_allocator<U, t_alignment> const&) {
+  }
+
+  template <typename U>
+  struct rebind {
+    typedef aligned_allocator<U, t_alignment> other;
+  };
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t{t_alignment}));
+  }
+
+  void deallocate(T* p, size_t) {
+    ::operator delete(p, std::align_val_t{t_alignment});
+  }
+
+  template <typename U>
+  bool operator==(aligned_allocator<U, t_alignment> const&) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(aligned_allocator<U, t_alignment> const&) const {
+    return false;
+  }
+};
+}  // namespace lce::util
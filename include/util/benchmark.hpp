@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * lce/util/benchmark.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io.hpp"
+
+// The parts that the benchmarks in src/lce share. The texts are passed as
+// non-const references, because lce_fp transforms its text in place and only
+// restores it when it is destroyed.
+namespace lce::util {
+
+// Whether the algorithm name is selected by the algorithm option, which is
+// one of the algorithms of the benchmark or "all".
+inline bool is_selected(std::string_view selected, std::string_view name) {
+  return selected == "all" || selected == name;
+}
+
+// Print the algorithms and return false if selected is not one of them.
+inline bool check_algorithm(std::vector<std::string> const& algorithms,
+                            std::string const& selected) {
+  if (std::find(algorithms.begin(), algorithms.end(), selected) ==
+      algorithms.end()) {
+    fmt::print("Algorithm {} is not specified.\n Use one of {}\n", selected,
+               algorithms);
+    return false;
+  }
+  return true;
+}
+
+// Print an error and return false if the text file is missing or empty.
+inline bool check_text_file(std::filesystem::path const& path) {
+  if (!std::filesystem::is_regular_file(path) ||
+      std::filesystem::file_size(path) == 0) {
+    fmt::print("Text file {} is empty or does not exist.\n", path.string());
+    return false;
+  }
+  return true;
+}
+
+// Load a text padded to a multiple of 8 symbols, which lce_fp needs. The
+// padding may add a run of zeros at the end.
+inline std::vector<uint8_t> load_text(
+    std::filesystem::path const& path,
+    size_t prefix_size = std::numeric_limits<size_t>::max(),
+    size_t excess = 0) {
+  return load_vector<uint8_t>(path, prefix_size, excess, 8);
+}
+
+// The results of the first algorithm that is run, the results of the others
+// are checked against them.
+template <typename t_result>
+class result_checker {
+ public:
+  // Print whether result equals the one of the first algorithm, the first
+  // result is stored.
+  void check(t_result const& result) {
+    if (!m_has_reference) {
+      m_reference = result;
+      m_has_reference = true;
+      return;
+    }
+    fmt::print(" check={}", result == m_reference ? "ok" : "failed");
+  }
+
+  bool has_reference() const {
+    return m_has_reference;
+  }
+
+ private:
+  t_result m_reference;
+  bool m_has_reference = false;
+};
+
+// The help text of the tau option, see dispatch_tau.
+static constexpr char const* tau_description =
+    "Tau of lce_sss. Options: 256, 512, 1024, 2048 (default: 512).";
+
+// Call run.template operator()<tau>() if tau is one of the taus the
+// benchmarks are compiled for, otherwise print an error and return false.
+template <typename t_run>
+bool dispatch_tau(size_t tau, t_run&& run) {
+  if (tau == 256) {
+    run.template operator()<256>();
+  } else if (tau == 512) {
+    run.template operator()<512>();
+  } else if (tau == 1024) {
+    run.template operator()<1024>();
+  } else if (tau == 2048) {
+    run.template operator()<2048>();
+  } else {
+    fmt::print("Unsupported tau {}.\n", tau);
+    return false;
+  }
+  return true;
+}
+}  // namespace lce::util
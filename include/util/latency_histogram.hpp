@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * lce/util/latency_histogram.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace lce::util {
+
+// Histogram of latencies (e.g. in nanoseconds) with logarithmic buckets: each
+// power of two is split into 2^t_sub_bits linear buckets, so a percentile is
+// off by at most a factor of 1 + 2^-t_sub_bits. Values below 2^t_sub_bits are
+// exact.
+template <uint64_t t_sub_bits = 5>
+class latency_histogram {
+ public:
+  static constexpr uint64_t num_sub_buckets = uint64_t{1} << t_sub_bits;
+  static constexpr uint64_t num_buckets = (65 - t_sub_bits) * num_sub_buckets;
+
+  latency_histogram() {
+    clear();
+  }
+
+  void clear() {
+    m_counts.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+  }
+
+  inline void record(uint64_t value) {
+    ++m_counts[bucket(value)];
+    ++m_count;
+    m_sum += value;
+    m_max = std::max(m_max, value);
+  }
+
+  void merge(latency_histogram const& other) {
+    for (size_t i = 0; i < num_buckets; ++i) {
+      m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = std::max(m_max, other.m_max);
+  }
+
+  // Return the smallest bucket bound such that at least a fraction q of all
+  // values are not larger (the maximum for q = 1).
+  uint64_t percentile(double q) const {
+    if (m_count == 0) {
+      return 0;
+    }
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(q * m_count + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < num_buckets; ++i) {
+      seen += m_counts[i];
+      if (seen >= rank) {
+        return std::min(upper_bound(i), m_max);
+      }
+    }
+    return m_max;
+  }
+
+  uint64_t count() const {
+    return m_count;
+  }
+
+  uint64_t max() const {
+    return m_max;
+  }
+
+  double mean() const {
+    return m_count == 0 ? 0.0 : double(m_sum) / m_count;
+  }
+
+  // Call f(lower, upper, count) for each non-empty bucket, where all values
+  // of the bucket are in [lower, upper].
+  template <typename F>
+  void for_each_bucket(F&& f) const {
+    for (size_t i = 0; i < num_buckets; ++i) {
+      if (m_counts[i] != 0) {
+        f(lower_bound(i), upper_bound(i), m_counts[i]);
+      }
+    }
+  }
+
+ private:
+  inline static size_t bucket(uint64_t value) {
+    if (value < num_sub_buckets) {
+      return value;
+    }
+    // the highest t_sub_bits + 1 bits determine the bucket
+    const uint64_t exp = std::bit_width(value) - t_sub_bits - 1;
+    const uint64_t sub = (value >> exp) - num_sub_buckets;
+    return (exp + 1) * num_sub_buckets + sub;
+  }
+
+  inline static uint64_t lower_bound(size_t i) {
+    if (i < num_sub_buckets) {
+      return i;
+    }
+    const uint64_t exp = i / num_sub_buckets - 1;
+    const uint64_t sub = i % num_sub_buckets;
+    return (num_sub_buckets + sub) << exp;
+  }
+
+  inline static uint64_t upper_bound(size_t i) {
+    if (i < num_sub_buckets) {
+      return i;
+    }
+    const uint64_t exp = i / num_sub_buckets - 1;
+    return lower_bound(i) + ((uint64_t{1} << exp) - 1);
+  }
+
+  std::array<uint64_t, num_buckets> m_counts;
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_max;
+};
+
+// Return the overhead in nanoseconds of taking two timestamps with
+// steady_clock, which is subtracted from single query latencies.
+inline uint64_t steady_clock_overhead_ns() {
+  typedef std::chrono::steady_clock clock;
+  uint64_t min_overhead = UINT64_MAX;
+  for (size_t i = 0; i < 1000; ++i) {
+    const auto begin = clock::now();
+    const auto end = clock::now();
+    min_overhead = std::min<uint64_t>(
+        min_overhead,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+            .count());
+  }
+  return min_overhead;
+}
+}  // namespace lce::util
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * lce/util/memory_breakdown.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace lce::util {
+
+// The bytes a data structure holds per component (e.g. "sss", "isa",
+// "rmq_levels"), computed from the capacities of its members. It has a fixed
+// number of slots and never allocates, so it can be queried in production
+// builds without malloc_count. The text itself is never included.
+class memory_breakdown {
+ public:
+  static constexpr size_t max_components = 16;
+
+  struct component {
+    std::string_view name;
+    size_t bytes;
+  };
+
+  // Add bytes to the component with the given name (names must be string
+  // literals, they aren't copied).
+  void add(std::string_view name, size_t bytes) {
+    for (size_t i = 0; i < m_size; ++i) {
+      if (m_components[i].name == name) {
+        m_components[i].bytes += bytes;
+        return;
+      }
+    }
+    if (m_size < max_components) {
+      m_components[m_size++] = {name, bytes};
+    }
+  }
+
+  // Add all components of a nested data structure.
+  void add(memory_breakdown const& other) {
+    for (auto const& c : other) {
+      add(c.name, c.bytes);
+    }
+  }
+
+  template <typename T>
+  void add(std::string_view name, std::vector<T> const& vec) {
+    add(name, vec.capacity() * sizeof(T));
+  }
+
+  size_t total() const {
+    size_t sum = 0;
+    for (auto const& c : *this) {
+      sum += c.bytes;
+    }
+    return sum;
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+  component const* begin() const {
+    return m_components.data();
+  }
+
+  component const* end() const {
+    return m_components.data() + m_size;
+  }
+
+ private:
+  std::array<component, max_components> m_components{};
+  size_t m_size = 0;
+};
+}  // namespace lce::util
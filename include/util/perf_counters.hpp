@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * lce/util/perf_counters.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <fmt/core.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lce::util {
+
+// A group of hardware performance counters (cycles, instructions, LLC misses,
+// dTLB misses, branch misses) of the calling thread, read with
+// perf_event_open. Like timer, the counters start at construction and
+// print_and_reset() reports the events since the last reset. Only user space
+// is counted, which works with perf_event_paranoid <= 2. Threads that exist
+// before the construction (e.g. the OpenMP pool) aren't counted, so run
+// parallel phases with OMP_NUM_THREADS=1 for complete numbers. If the
+// counters can't be opened (no Linux, no PMU in a VM, ...), nothing is
+// printed. If the kernel multiplexes the group with other users, the values
+// are scaled to the whole time, and if the group was never scheduled, it is
+// reported as not counted instead of as 0.
+class perf_counters {
+ public:
+  static constexpr size_t num_events = 5;
+
+  perf_counters() {
+#ifdef __linux__
+    static constexpr std::array<std::pair<uint32_t, uint64_t>, num_events>
+        events{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        }};
+    for (size_t i = 0; i < num_events; ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = events[i].first;
+      attr.config = events[i].second;
+      attr.disabled = (i == 0);
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      m_fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1,
+                         (i == 0) ? -1 : m_fds[0], 0);
+      if (m_fds[i] < 0) {
+        close_all();
+        return;
+      }
+    }
+    ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    reset();
+#endif
+  }
+
+  perf_counters(perf_counters const&) = delete;
+  perf_counters& operator=(perf_counters const&) = delete;
+
+  ~perf_counters() {
+    close_all();
+  }
+
+  bool available() const {
+    return m_fds[0] >= 0;
+  }
+
+  void reset() {
+#ifdef __linux__
+    if (available()) {
+      ioctl(m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      // the reset doesn't clear the enabled and running times
+      buffer_type buffer;
+      if (read_group(buffer)) {
+        m_time_enabled = buffer[1];
+        m_time_running = buffer[2];
+      }
+    }
+#endif
+  }
+
+  // Return the events since the last reset, scaled by the time the group was
+  // enabled over the time it was running. Return nothing if the counters are
+  // not available or the group was not running since the last reset.
+  std::optional<std::array<uint64_t, num_events>> get() const {
+    double running_share;
+    return get(running_share);
+  }
+
+  // Print the events since the last reset as RESULT fields, e.g.
+  // " sss_cycles=...", and reset the counters.
+  void print_and_reset(std::string_view prefix) {
+    if (!available()) {
+      return;
+    }
+    double running_share = 0;
+    const auto counted = get(running_share);
+    if (!counted) {
+      fmt::print(" {}_perf=not_counted", prefix);
+      reset();
+      return;
+    }
+    const auto& values = *counted;
+    fmt::print(" {}_cycles={}", prefix, values[0]);
+    fmt::print(" {}_instructions={}", prefix, values[1]);
+    fmt::print(" {}_llc_misses={}", prefix, values[2]);
+    fmt::print(" {}_dtlb_misses={}", prefix, values[3]);
+    fmt::print(" {}_branch_misses={}", prefix, values[4]);
+    fmt::print(" {}_ipc={:.2f}", prefix,
+               values[0] == 0 ? 0.0 : double(values[1]) / values[0]);
+    fmt::print(" {}_perf_running={:.2f}", prefix, running_share);
+    reset();
+  }
+
+ private:
+  // layout of the group read: number of events, time enabled, time running,
+  // then the values
+  typedef std::array<uint64_t, num_events + 3> buffer_type;
+
+#ifdef __linux__
+  bool read_group(buffer_type& buffer) const {
+    return ::read(m_fds[0], buffer.data(), sizeof(buffer)) ==
+           static_cast<ssize_t>(sizeof(buffer));
+  }
+#endif
+
+  // Like get(), running_share is set to the share of the time since the last
+  // reset in which the group was counting (1 unless it was multiplexed).
+  std::optional<std::array<uint64_t, num_events>> get(
+      double& running_share) const {
+#ifdef __linux__
+    buffer_type buffer;
+    if (!available() || !read_group(buffer)) {
+      return std::nullopt;
+    }
+    const uint64_t enabled = buffer[1] - m_time_enabled;
+    const uint64_t running = buffer[2] - m_time_running;
+    if (running == 0) {
+      return std::nullopt;
+    }
+    running_share = (running < enabled) ? double(running) / enabled : 1.0;
+    std::array<uint64_t, num_events> values;
+    for (size_t i = 0; i < num_events; ++i) {
+      values[i] = uint64_t(buffer[i + 3] / running_share);
+    }
+    return values;
+#else
+    return std::nullopt;
+#endif
+  }
+
+  void close_all() {
+#ifdef __linux__
+    for (auto& fd : m_fds) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+      fd = -1;
+    }
+#endif
+  }
+
+  std::array<int, num_events> m_fds{-1, -1, -1, -1, -1};
+  uint64_t m_time_enabled = 0;
+  uint64_t m_time_running = 0;
+};
+}  // namespace lce::util
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * lce/util/query_stats.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace lce::util {
+
+#ifdef LCE_QUERY_STATS
+static constexpr bool query_stats_enabled = true;
+#else
+static constexpr bool query_stats_enabled = false;
+#endif
+
+// Counters of the query paths of the sss variants: which case answers a query,
+// how many bytes the naive scans compare and how many successor and rmq
+// queries are needed. The counters are per thread. Unless LCE_QUERY_STATS is
+// defined, the count functions are empty and compile to nothing.
+struct query_stats {
+  static constexpr size_t max_cases = 4;
+
+  std::array<uint64_t, max_cases> cases{};
+  uint64_t scans = 0;
+  uint64_t scanned_bytes = 0;
+  uint64_t pred_calls = 0;
+  uint64_t rmq_calls = 0;
+
+  void reset() {
+    *this = query_stats{};
+  }
+
+  static query_stats& local() {
+    thread_local query_stats stats;
+    return stats;
+  }
+
+  inline static void count_case(size_t c) {
+    if constexpr (query_stats_enabled) {
+      ++local().cases[c];
+    }
+  }
+
+  // Like count_case(c), and c is also stored in query_case unless it is null.
+  // This works without LCE_QUERY_STATS.
+  inline static void count_case(size_t c, uint64_t* query_case) {
+    count_case(c);
+    if (query_case != nullptr) {
+      *query_case = c;
+    }
+  }
+
+  // a naive scan that found lce common symbols and was bounded by max_lce
+  // compared min(lce + 1, max_lce) symbols
+  inline static void count_scan(size_t lce, size_t max_lce) {
+    if constexpr (query_stats_enabled) {
+      ++local().scans;
+      local().scanned_bytes += std::min(lce + 1, max_lce);
+    }
+  }
+
+  inline static void count_pred(size_t num = 1) {
+    if constexpr (query_stats_enabled) {
+      local().pred_calls += num;
+    }
+  }
+
+  inline static void count_rmq() {
+    if constexpr (query_stats_enabled) {
+      ++local().rmq_calls;
+    }
+  }
+};
+}  // namespace lce::util
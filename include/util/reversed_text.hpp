@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * lce/util/reversed_text.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lce::util {
+
+// The text text[0, size) read from right to left, i.e. view[i] is
+// text[size - 1 - i]. It doesn't copy the text, the naive scans over it (see
+// lce_naive_wordwise_xor) read words of the original buffer.
+template <typename t_char_type = uint8_t>
+class reversed_text {
+ public:
+  typedef t_char_type char_type;
+
+  reversed_text() : m_text(nullptr), m_size(0) {
+  }
+
+  reversed_text(char_type const* text, size_t size)
+      : m_text(text), m_size(size) {
+  }
+
+  char_type operator[](size_t i) const {
+    return m_text[m_size - 1 - i];
+  }
+
+  // Return the position in the original text of view position i.
+  size_t original_pos(size_t i) const {
+    return m_size - 1 - i;
+  }
+
+  // The original (not reversed) text.
+  char_type const* data() const {
+    return m_text;
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+ private:
+  char_type const* m_text;
+  size_t m_size;
+};
+}  // namespace lce::util
@@ -0,0 +1,276 @@
+/*******************************************************************************
+ * lce/util/synthetic_text.hpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../ds/lce_naive_wordwise_xor.hpp"
+
+namespace lce::util {
+
+static const std::vector<std::string> synthetic_families{
+    "uniform", "dna", "fibonacci", "thue_morse", "periodic", "repetitive"};
+
+// text[i + shift] is expected to equal text[i] for most i in [begin, end), so
+// (i, i + shift) is a query with a long lce
+struct synthetic_repeat {
+  size_t begin;
+  size_t end;
+  size_t shift;
+};
+
+struct synthetic_text {
+  std::vector<uint8_t> text;
+  std::vector<synthetic_repeat> repeats;
+};
+
+namespace synthetic {
+
+// Return a value in [min, max] whose logarithm is uniform.
+inline size_t log_uniform(std::mt19937_64& gen, size_t min, size_t max) {
+  assert(0 < min && min <= max);
+  std::uniform_real_distribution<double> dist(std::log2(double(min)),
+                                              std::log2(double(max) + 1));
+  return std::clamp<size_t>(std::exp2(dist(gen)), min, max);
+}
+
+// Random symbols of the alphabet {first, ..., first + sigma - 1}.
+inline void fill_random(std::vector<uint8_t>& text, size_t begin, size_t end,
+                        std::mt19937_64& gen, uint8_t first, uint16_t sigma) {
+  std::uniform_int_distribution<uint16_t> dist(0, sigma - 1);
+  for (size_t i = begin; i < end; ++i) {
+    text[i] = first + dist(gen);
+  }
+}
+
+// Fill text[begin, size) with copies of earlier segments with log-uniform
+// lengths in [min_len, max_len], each symbol mutated with the given rate.
+// Between two copies there are random symbols with an expected length of
+// gap_len (no gaps if gap_len is 0).
+inline void fill_copies(synthetic_text& st, size_t begin,
+                        std::mt19937_64& gen, size_t min_len, size_t max_len,
+                        double mutation_rate, size_t gap_len, uint8_t first,
+                        uint16_t sigma) {
+  auto& text = st.text;
+  std::geometric_distribution<size_t> next_mutation(mutation_rate);
+  std::geometric_distribution<size_t> gap(gap_len == 0 ? 1.0
+                                                       : 1.0 / (gap_len + 1));
+  std::uniform_int_distribution<uint16_t> symbol(1, sigma - 1);
+  size_t pos = begin;
+  while (pos < text.size()) {
+    const size_t gap_end = std::min(text.size(), pos + gap(gen));
+    fill_random(text, pos, gap_end, gen, first, sigma);
+    pos = gap_end;
+    if (pos == text.size()) {
+      break;
+    }
+
+    const size_t len = std::min(log_uniform(gen, min_len, max_len),
+                                std::min(pos, text.size() - pos));
+    const size_t src =
+        std::uniform_int_distribution<size_t>(0, pos - len)(gen);
+    std::copy(text.begin() + src, text.begin() + src + len,
+              text.begin() + pos);
+    // a mutation adds a value in [1, sigma) modulo sigma, so it changes the
+    // symbol
+    for (size_t i = next_mutation(gen); i < len; i += 1 + next_mutation(gen)) {
+      text[pos + i] = first + (text[pos + i] - first + symbol(gen)) % sigma;
+    }
+    st.repeats.push_back({src, src + len, pos - src});
+    pos += len;
+  }
+}
+
+inline synthetic_text uniform(size_t size, std::mt19937_64& gen) {
+  synthetic_text st{std::vector<uint8_t>(size), {}};
+  fill_random(st.text, 0, size, gen, 0, 256);
+  return st;
+}
+
+// ACGT with roughly 40% of the text being mutated copies of earlier
+// segments (like interspersed repeats), the rest is random.
+inline synthetic_text dna(size_t size, std::mt19937_64& gen) {
+  synthetic_text st{std::vector<uint8_t>(size), {}};
+  const size_t prefix = std::min<size_t>(size, 1024);
+  fill_random(st.text, 0, prefix, gen, 0, 4);
+  fill_copies(st, prefix, gen, 16, 8192, 0.01, 2048, 0, 4);
+  static constexpr uint8_t acgt[4]{'A', 'C', 'G', 'T'};
+  for (auto& c : st.text) {
+    c = acgt[c];
+  }
+  return st;
+}
+
+// The Fibonacci word, which has a run of period F_k for each k.
+inline synthetic_text fibonacci(size_t size) {
+  synthetic_text st{std::vector<uint8_t>(size), {}};
+  std::vector<uint8_t>& text = st.text;
+  if (size == 0) {
+    return st;
+  }
+  text[0] = 'a';
+  size_t len = 1;
+  size_t prev_len = 0;
+  // S_k = S_{k-1} S_{k-2}, where S_{k-2} is a prefix of S_{k-1}
+  while (len < size) {
+    const size_t add = std::min(prev_len == 0 ? 1 : prev_len, size - len);
+    if (prev_len == 0) {
+      text[len] = 'b';
+    } else {
+      std::copy(text.begin(), text.begin() + add, text.begin() + len);
+    }
+    prev_len = len;
+    len += add;
+  }
+  for (size_t a = 1, b = 2; b < size; std::swap(a, b), b += a) {
+    st.repeats.push_back({0, size - b, b});
+  }
+  return st;
+}
+
+// The Thue-Morse word, which is overlap-free but has long squares of lengths
+// 2^k and 3 * 2^k.
+inline synthetic_text thue_morse(size_t size) {
+  synthetic_text st{std::vector<uint8_t>(size), {}};
+  for (size_t i = 0; i < size; ++i) {
+    st.text[i] = 'a' + (std::popcount(i) & 1);
+  }
+  for (size_t k = 1; k < size; k <<= 1) {
+    st.repeats.push_back({0, size - k, k});
+    if (3 * k < size) {
+      st.repeats.push_back({0, size - 3 * k, 3 * k});
+    }
+  }
+  return st;
+}
+
+// Runs with log-uniform periods in [1, 512] and log-uniform lengths of up to
+// 2^20, separated by short random gaps.
+inline synthetic_text periodic(size_t size, std::mt19937_64& gen) {
+  synthetic_text st{std::vector<uint8_t>(size), {}};
+  auto& text = st.text;
+  size_t pos = 0;
+  while (pos < size) {
+    const size_t gap_end = std::min(size, pos + log_uniform(gen, 1, 64));
+    fill_random(text, pos, gap_end, gen, 0, 256);
+    pos = gap_end;
+    if (pos == size) {
+      break;
+    }
+
+    const size_t period = std::min(log_uniform(gen, 1, 512), size - pos);
+    const size_t len = std::min(
+        log_uniform(gen, 2 * period, std::max<size_t>(2 * period, 1 << 20)),
+        size - pos);
+    fill_random(text, pos, pos + period, gen, 0, 256);
+    for (size_t i = pos + period; i < pos + len; ++i) {
+      text[i] = text[i - period];
+    }
+    if (len > period) {
+      st.repeats.push_back({pos, pos + len - period, period});
+    }
+    pos += len;
+  }
+  return st;
+}
+
+// A random prefix of 64 KiB followed by mutated copies of earlier segments,
+// like a collection of versions of the same document.
+inline synthetic_text repetitive(size_t size, std::mt19937_64& gen) {
+  synthetic_text st{std::vector<uint8_t>(size), {}};
+  const size_t prefix = std::min<size_t>(size, 1 << 16);
+  fill_random(st.text, 0, prefix, gen, 0, 256);
+  fill_copies(st, prefix, gen, 64, 1 << 20, 1e-5, 0, 0, 256);
+  return st;
+}
+}  // namespace synthetic
+
+inline bool is_synthetic_family(std::string_view family) {
+  return std::find(synthetic_families.begin(), synthetic_families.end(),
+                   family) != synthetic_families.end();
+}
+
+// Generate a text of the given family (see synthetic_families) and its
+// repeats, which are used to generate queries with long lces.
+inline synthetic_text generate_synthetic_text(std::string_view family,
+                                              size_t size, uint64_t seed) {
+  assert(is_synthetic_family(family));
+  std::mt19937_64 gen(seed);
+  if (family == "dna") {
+    return synthetic::dna(size, gen);
+  } else if (family == "fibonacci") {
+    return synthetic::fibonacci(size);
+  } else if (family == "thue_morse") {
+    return synthetic::thue_morse(size);
+  } else if (family == "periodic") {
+    return synthetic::periodic(size, gen);
+  } else if (family == "repetitive") {
+    return synthetic::repetitive(size, gen);
+  }
+  return synthetic::uniform(size, gen);
+}
+
+// Queries stratified like those of gen_queries: queries[x] holds up to limit
+// pairs (i, j) (flattened) with min(bit_width(lce(i, j)), max_lce_exp) = x.
+// Candidates are random pairs and pairs from the repeats, where the distance
+// to the end of the repeat is log-uniform. Buckets the text has (almost) no
+// queries for stay incomplete, the number of candidates is bounded.
+template <size_t t_max_lce_exp = 20>
+std::array<std::vector<size_t>, t_max_lce_exp + 1> generate_synthetic_queries(
+    synthetic_text const& st, size_t limit, uint64_t seed) {
+  std::array<std::vector<size_t>, t_max_lce_exp + 1> queries;
+  auto const& text = st.text;
+  if (text.size() < 2 || limit == 0) {
+    return queries;
+  }
+
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<size_t> pos(0, text.size() - 1);
+  std::uniform_int_distribution<size_t> repeat(
+      0, std::max<size_t>(st.repeats.size(), 1) - 1);
+  size_t num_full = 0;
+  const size_t max_candidates = 64 * limit * (t_max_lce_exp + 1);
+  for (size_t c = 0; c < max_candidates && num_full <= t_max_lce_exp; ++c) {
+    size_t i;
+    size_t j;
+    if (st.repeats.empty() || (c & 3) == 0) {
+      i = pos(gen);
+      j = pos(gen);
+      if (i == j) {
+        continue;
+      }
+    } else {
+      auto const& r = st.repeats[repeat(gen)];
+      i = r.end - synthetic::log_uniform(gen, 1, r.end - r.begin);
+      j = i + r.shift;
+    }
+
+    // everything from 2^(max_lce_exp - 1) on is in the last bucket
+    const size_t lce = ds::lce_naive_wordwise_xor<uint8_t>::lce_up_to(
+        text.data(), text.size(), i, j, size_t{1} << (t_max_lce_exp - 1));
+    const size_t x = std::min<size_t>(std::bit_width(lce), t_max_lce_exp);
+    if (queries[x].size() < 2 * limit) {
+      queries[x].push_back(i);
+      queries[x].push_back(j);
+      num_full += (queries[x].size() == 2 * limit);
+    }
+  }
+  return queries;
+}
+}  // namespace lce::util
@@ -0,0 +1,353 @@
+/*******************************************************************************
+ * src/kernels/benchmark.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+// Microbenchmarks of the kernels the data structures are built from. All
+// inputs are synthetic, so no text or query files are needed. Every kernel is
+// run once for warm-up and then --reps times; the RESULT line reports the
+// nanoseconds per operation over the repetitions.
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "bit_vector/bit_rank.hpp"
+#include "bit_vector/bit_vector.hpp"
+#include "ds/lce_fp.hpp"
+#include "ds/lce_naive_wordwise_xor.hpp"
+#include "pred/adaptive_pred_index.hpp"
+#include "pred/binsearch_cache.hpp"
+#include "pred/binsearch_std.hpp"
+#include "pred/compressed_sss_index.hpp"
+#include "pred/elias_fano_index.hpp"
+#include "pred/j_index.hpp"
+#include "pred/pgm_index.hpp"
+#include "pred/pred_index.hpp"
+#include "pred/radix_spline_index.hpp"
+#include "pred/rank_index.hpp"
+#include "pred/s_tree_index.hpp"
+#include "rmq/rmq_n.hpp"
+#include "rmq/rmq_nlgn.hpp"
+#include "rolling_hash/mersenne_modular_arithmetic.hpp"
+#include "rolling_hash/rolling_hash.hpp"
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+class benchmark {
+ public:
+  std::string kernel = "all";
+  size_t reps = 11;
+  size_t num_ops = 1'000'000;
+  size_t text_size = size_t{1} << 24;
+  size_t num_keys = size_t{1} << 22;
+  uint64_t seed = 42;
+
+  void run() {
+    m_gen.seed(seed);
+    bench_lce_xor();
+    bench_lce_fp();
+    bench_roll();
+    bench_mod();
+    bench_rmq();
+    bench_pred();
+    bench_bit_rank();
+    fmt::print("check_sum={}\n", m_sink);
+  }
+
+ private:
+  // whether --kernel selects the kernel (name is a prefix of the kernel name
+  // or vice versa), so the inputs of skipped kernels aren't built
+  bool enabled(std::string const& name) const {
+    return kernel == "all" || name.starts_with(kernel) ||
+           kernel.starts_with(name);
+  }
+
+  // Run f (which performs num_ops operations and returns a value that
+  // depends on all of them) once for warm-up and then reps times.
+  template <typename F>
+  void measure(std::string const& name, std::string const& param, F&& f) {
+    if (!enabled(name)) {
+      return;
+    }
+    m_sink += f();
+    std::vector<double> ns_per_op(reps);
+    for (size_t r = 0; r < reps; ++r) {
+      const auto begin = std::chrono::steady_clock::now();
+      m_sink += f();
+      const auto end = std::chrono::steady_clock::now();
+      ns_per_op[r] =
+          std::chrono::duration<double, std::nano>(end - begin).count() /
+          num_ops;
+    }
+
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    double mean = 0;
+    for (const double x : ns_per_op) {
+      mean += x;
+    }
+    mean /= reps;
+    double variance = 0;
+    for (const double x : ns_per_op) {
+      variance += (x - mean) * (x - mean);
+    }
+    variance /= std::max<size_t>(1, reps - 1);
+
+    fmt::print("RESULT kernel={} param={} ops={} reps={}", name, param,
+               num_ops, reps);
+    fmt::print(" ns_min={:.2f} ns_median={:.2f} ns_mean={:.2f}", ns_per_op[0],
+               ns_per_op[reps / 2], mean);
+    fmt::print(" ns_max={:.2f} ns_stddev={:.2f}\n", ns_per_op[reps - 1],
+               std::sqrt(variance));
+  }
+
+  // Random positions that are multiples of stride and leave room for len.
+  std::vector<size_t> positions(size_t range, size_t stride, size_t len) {
+    std::uniform_int_distribution<size_t> dist(0, (range - len) / stride);
+    std::vector<size_t> pos(num_ops);
+    for (auto& p : pos) {
+      p = dist(m_gen) * stride;
+    }
+    return pos;
+  }
+
+  // Both halves of the text are equal up to a mismatch every len + 1
+  // symbols, so the lce of (k * (len + 1), half + k * (len + 1)) is len.
+  std::vector<uint8_t> lce_text(size_t len) {
+    const size_t half = text_size / 2;
+    std::vector<uint8_t> text(text_size);
+    std::uniform_int_distribution<uint16_t> dist(0, 255);
+    for (size_t i = 0; i < half; ++i) {
+      text[i] = dist(m_gen);
+      text[half + i] = text[i];
+    }
+    for (size_t i = len; i < half; i += len + 1) {
+      text[half + i] = ~text[i];
+    }
+    return text;
+  }
+
+  void bench_lce_xor() {
+    if (!enabled("lce_xor")) {
+      return;
+    }
+    for (const size_t len : {8, 64, 512, 4096, 32768}) {
+      const auto text = lce_text(len);
+      const auto pos = positions(text_size / 2, len + 1, len + 1);
+      lce::ds::lce_naive_wordwise_xor<uint8_t> ds(text);
+      measure("lce_xor", std::to_string(len), [&] {
+        size_t sum = 0;
+        for (const size_t p : pos) {
+          sum += ds.lce_lr(p, text_size / 2 + p);
+        }
+        return sum;
+      });
+    }
+  }
+
+  // fp_exp is private, lce() exercises it with about 2 log(len) calls
+  void bench_lce_fp() {
+    if (!enabled("lce_fp")) {
+      return;
+    }
+    for (const size_t len : {8, 64, 512, 4096, 32768}) {
+      auto text = lce_text(len);
+      const auto pos = positions(text_size / 2, len + 1, len + 1);
+      lce::ds::lce_fp<uint8_t> ds(text.data(), text.size());
+      measure("lce_fp", std::to_string(len), [&] {
+        size_t sum = 0;
+        for (const size_t p : pos) {
+          sum += ds.lce(p, text_size / 2 + p);
+        }
+        return sum;
+      });
+    }
+  }
+
+  template <size_t t_prime_exp>
+  void bench_roll(std::vector<uint8_t> const& text) {
+    lce::rolling_hash::rk_prime<t_prime_exp> rk(64);
+    measure("roll", std::to_string(t_prime_exp), [&] {
+      uint128_t fp = 0;
+      for (size_t i = 64; i < 64 + num_ops; ++i) {
+        fp = rk.roll(text[i - 64], text[i]);
+      }
+      return static_cast<size_t>(fp);
+    });
+  }
+
+  void bench_roll() {
+    if (!enabled("roll")) {
+      return;
+    }
+    std::vector<uint8_t> text(num_ops + 64);
+    std::uniform_int_distribution<uint16_t> dist(0, 255);
+    for (auto& c : text) {
+      c = dist(m_gen);
+    }
+    bench_roll<61>(text);
+    bench_roll<107>(text);
+  }
+
+  // a dependency chain, so the latency of mod is measured
+  template <size_t t_prime_exp>
+  void bench_mod() {
+    constexpr uint128_t prime = (uint128_t{1} << t_prime_exp) - 1;
+    const uint128_t base = m_gen() | 1;
+    measure("mod", std::to_string(t_prime_exp), [&] {
+      uint128_t x = base;
+      for (size_t i = 0; i < num_ops; ++i) {
+        x = lce::mersenne::mod<uint128_t, prime>(x * base + i);
+      }
+      return static_cast<size_t>(x);
+    });
+  }
+
+  void bench_mod() {
+    if (!enabled("mod")) {
+      return;
+    }
+    bench_mod<61>();
+    bench_mod<107>();
+  }
+
+  template <typename rmq_type>
+  void bench_rmq(std::string const& name, std::vector<uint64_t> const& data) {
+    rmq_type ds(data);
+    for (const size_t len : {size_t{16}, size_t{1024}, data.size() / 4}) {
+      std::uniform_int_distribution<size_t> dist(0, data.size() - len);
+      std::vector<size_t> begins(num_ops);
+      for (auto& b : begins) {
+        b = dist(m_gen);
+      }
+      measure(name, std::to_string(len), [&] {
+        size_t sum = 0;
+        for (const size_t b : begins) {
+          sum += ds.rmq(b, b + len - 1);
+        }
+        return sum;
+      });
+    }
+  }
+
+  void bench_rmq() {
+    if (!enabled("rmq")) {
+      return;
+    }
+    std::vector<uint64_t> data(text_size / 4);
+    for (auto& x : data) {
+      x = m_gen();
+    }
+    bench_rmq<lce::rmq::rmq_n<uint64_t>>("rmq_n", data);
+    bench_rmq<lce::rmq::rmq_nlgn<uint64_t>>("rmq_nlgn", data);
+  }
+
+  template <typename pred_type>
+  void bench_succ(std::string const& name, std::vector<uint64_t> const& keys,
+                  std::vector<uint64_t> const& queries) {
+    if (!enabled("succ_" + name)) {
+      return;
+    }
+    pred_type ds(keys);
+    measure("succ_" + name, std::to_string(keys.size()), [&] {
+      size_t sum = 0;
+      for (const uint64_t q : queries) {
+        sum += ds.successor(q).pos;
+      }
+      return sum;
+    });
+  }
+
+  void bench_pred() {
+    if (!enabled("succ_")) {
+      return;
+    }
+    // sorted keys with gaps of at most 256, like a string synchronizing set
+    std::vector<uint64_t> keys(num_keys);
+    std::uniform_int_distribution<uint64_t> gap(1, 256);
+    keys[0] = gap(m_gen);
+    for (size_t i = 1; i < num_keys; ++i) {
+      keys[i] = keys[i - 1] + gap(m_gen);
+    }
+    std::uniform_int_distribution<uint64_t> dist(keys[0], keys.back());
+    std::vector<uint64_t> queries(num_ops);
+    for (auto& q : queries) {
+      q = dist(m_gen);
+    }
+
+    using namespace lce::pred;
+    bench_succ<binsearch_std<uint64_t>>("binsearch_std", keys, queries);
+    bench_succ<binsearch_cache<uint64_t>>("binsearch_cache", keys, queries);
+    bench_succ<j_index<uint64_t>>("j_index", keys, queries);
+    bench_succ<rank_index<uint64_t>>("rank_index", keys, queries);
+    bench_succ<s_tree_index<uint64_t>>("s_tree", keys, queries);
+    bench_succ<radix_spline_index<uint64_t>>("radix_spline", keys, queries);
+    bench_succ<pgm_index<uint64_t, 32>>("pgm_index", keys, queries);
+    bench_succ<pred_index<uint64_t, 8, uint32_t>>("pred_index", keys, queries);
+    bench_succ<adaptive_pred_index<uint64_t>>("pred_index_adaptive", keys,
+                                              queries);
+    bench_succ<elias_fano_index<uint64_t>>("elias_fano", keys, queries);
+    bench_succ<compressed_sss_index<uint64_t>>("compressed_sss", keys,
+                                               queries);
+  }
+
+  void bench_bit_rank() {
+    if (!enabled("bit_rank")) {
+      return;
+    }
+    stash::bit_vector bv(text_size * 4);
+    for (size_t i = 0; i < bv.size(); ++i) {
+      bv[i] = m_gen() & 1;
+    }
+    stash::bit_rank rank(bv);
+    const auto pos = positions(bv.size(), 1, 1);
+    measure("bit_rank", std::to_string(bv.size()), [&] {
+      size_t sum = 0;
+      for (const size_t p : pos) {
+        sum += rank.rank1(p);
+      }
+      return sum;
+    });
+  }
+
+  std::mt19937_64 m_gen;
+  size_t m_sink = 0;
+};
+
+int main(int argc, char** argv) {
+  benchmark b;
+  tlx::CmdlineParser cp;
+  cp.set_description("Microbenchmarks of the LCE kernels on synthetic data.");
+  cp.add_string('k', "kernel", b.kernel,
+                "Only run kernels whose name starts with this (e.g. lce_xor, "
+                "roll, mod, rmq_n, succ_, bit_rank). Default: all");
+  cp.add_size_t('r', "reps", b.reps, "Repetitions per kernel (default 11).");
+  cp.add_size_t('n', "ops", b.num_ops,
+                "Operations per repetition (default 1000000).");
+  cp.add_size_t('t', "text_size", b.text_size,
+                "Size of the synthetic texts (default 16 MiB).");
+  cp.add_size_t('p', "keys", b.num_keys,
+                "Number of keys of the predecessor kernels (default 4 Mi).");
+  cp.add_size_t('s', "seed", b.seed, "Seed of the synthetic data.");
+
+  if (!cp.process(argc, argv)) {
+    return -1;
+  }
+  if (b.reps == 0 || b.num_ops == 0 || b.text_size < (size_t{1} << 21)) {
+    fmt::print("reps and ops must be positive, text_size at least 2 MiB\n");
+    return -1;
+  }
+  b.text_size -= b.text_size % 8;
+  b.run();
+  return 0;
+}
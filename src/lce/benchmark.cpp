@@ -15,7 +15,10 @@
 #include <omp.h>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <gsaca-double-sort/uint_types.hpp>
 #include <iostream>
 #include <string>
@@ -34,9 +37,20 @@
 #include "ds/lce_naive_wordwise_xor.hpp"
 #include "ds/lce_rk_prezza.hpp"
 #include "ds/lce_sss.hpp"
+#include "ds/lce_sss_bidirectional.hpp"
+#include "ds/lce_sss_fp.hpp"
 #include "ds/lce_sss_naive.hpp"
 #include "ds/lce_sss_noss.hpp"
+#include "pred/compressed_sss_index.hpp"
+#include "pred/elias_fano_index.hpp"
+#include "pred/radix_spline_index.hpp"
+#include "pred/s_tree_index.hpp"
 #include "util/io.hpp"
+#include "util/latency_histogram.hpp"
+#include "util/query_stats.hpp"
+#ifdef LCE_BENCHMARK_PERF
+#include "util/perf_counters.hpp"
+#endif
 #include "util/timer.hpp"
 
 namespace fs = std::filesystem;
@@ -67,6 +81,14 @@ std::vector<std::string> algorithms{"naive",
                                     "sss_noss512pl",
                                     "sss_noss1024pl",
                                     "sss_noss2048pl",
+                                    "sss_fp256",
+                                    "sss_fp512",
+                                    "sss_fp1024",
+                                    "sss_fp2048",
+                                    "sss_fp256pl",
+                                    "sss_fp512pl",
+                                    "sss_fp1024pl",
+                                    "sss_fp2048pl",
                                     "sss256",
                                     "sss512",
                                     "sss1024",
@@ -75,6 +97,26 @@ std::vector<std::string> algorithms{"naive",
                                     "sss512pl",
                                     "sss1024pl",
                                     "sss2048pl",
+                                    "sss256_s_tree",
+                                    "sss512_s_tree",
+                                    "sss1024_s_tree",
+                                    "sss2048_s_tree",
+                                    "sss256_ef",
+                                    "sss512_ef",
+                                    "sss1024_ef",
+                                    "sss2048_ef",
+                                    "sss256_rs",
+                                    "sss512_rs",
+                                    "sss1024_rs",
+                                    "sss2048_rs",
+                                    "sss256_csss",
+                                    "sss512_csss",
+                                    "sss1024_csss",
+                                    "sss2048_csss",
+                                    "sss256_bidirectional",
+                                    "sss512_bidirectional",
+                                    "sss1024_bidirectional",
+                                    "sss2048_bidirectional",
                                     "classic",
                                     "sdsl_cst"};
 
@@ -89,13 +131,20 @@ std::vector<std::string> algorithms_par{
     "sss_naive256pl", "sss_naive512pl", "sss_naive1024pl", "sss_naive2048pl",
     "sss_noss256",    "sss_noss512",    "sss_noss1024",    "sss_noss2048",
     "sss_noss256pl",  "sss_noss512pl",  "sss_noss1024pl",  "sss_noss2048pl",
+    "sss_fp256",      "sss_fp512",      "sss_fp1024",      "sss_fp2048",
+    "sss_fp256pl",    "sss_fp512pl",    "sss_fp1024pl",    "sss_fp2048pl",
     "sss256",         "sss512",         "sss1024",         "sss2048",
     "sss256pl",       "sss512pl",       "sss1024pl",       "sss2048pl",
+    "sss256_s_tree",  "sss512_s_tree",  "sss1024_s_tree",  "sss2048_s_tree",
+    "sss256_ef",      "sss512_ef",      "sss1024_ef",      "sss2048_ef",
+    "sss256_rs",      "sss512_rs",      "sss1024_rs",      "sss2048_rs",
+    "sss256_csss",    "sss512_csss",    "sss1024_csss",    "sss2048_csss",
 };
 
 std::vector<std::string> algorithms_main{
     "naive_wordwise_xor", "fp64",          "sss_naive512", "sss_naive512pl",
-    "sss_noss512",        "sss_noss512pl", "sss512",       "sss512pl"};
+    "sss_noss512",        "sss_noss512pl", "sss_fp512",    "sss_fp512pl",
+    "sss512",             "sss512pl"};
 
 class benchmark {
  public:
@@ -110,6 +159,11 @@ class benchmark {
 
   std::string algorithm = "naive";
 
+  bool latency = false;
+  fs::path latency_csv_path;
+
+  size_t k_max = 0;
+
   bool check_parameters() {
     // Check text path
     if (!fs::is_regular_file(text_path) || fs::file_size(text_path) == 0) {
@@ -166,15 +220,32 @@ class benchmark {
 #ifdef LCE_BENCHMARK_SPACE
     malloc_count_reset_peak();
     size_t mem_before = malloc_count_current();
+#endif
+#ifdef LCE_BENCHMARK_PERF
+    lce::util::perf_counters perf;
 #endif
     lce::util::timer t;
     ds_type ds(text);
     fmt::print(" threads={}", omp_get_max_threads());
     fmt::print(" c_time={}", t.get());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("c");
+#endif
 #ifdef LCE_BENCHMARK_SPACE
     fmt::print(" c_mem={}", malloc_count_current() - mem_before);
     fmt::print(" c_mempeak={}", malloc_count_peak() - mem_before);
 #endif
+    if constexpr (requires { ds.memory_breakdown(); }) {
+      const auto mem = ds.memory_breakdown();
+      for (auto const& c : mem) {
+        fmt::print(" mem_{}={}", c.name, c.bytes);
+      }
+      fmt::print(" mem_total={}", mem.total());
+    }
+    if constexpr (requires { ds.memory_saved(); }) {
+      fmt::print(" mem_saved={}", ds.memory_saved());
+      fmt::print(" mirrored={}", ds.mirrored());
+    }
     return ds;
   }
 
@@ -206,13 +277,193 @@ class benchmark {
       return;
     }
     size_t check_sum = 0;
+    lce::util::query_stats::local().reset();
+#ifdef LCE_BENCHMARK_PERF
+    lce::util::perf_counters perf;
+#endif
     lce::util::timer t;
     for (size_t i = 0; i < queries.size(); i += 2) {
       check_sum += ds.lce(queries[i], queries[i + 1]);
     }
 
     fmt::print(" q_time={}", t.get());
+#ifdef LCE_BENCHMARK_PERF
+    perf.print_and_reset("q");
+#endif
     fmt::print(" check_sum={}", check_sum);
+    if constexpr (lce::util::query_stats_enabled) {
+      print_query_stats(queries.size() / 2);
+    }
+
+    if (latency) {
+      benchmark_latency<ds_type>(ds);
+    }
+  }
+
+  // Time longest common suffix queries on the current query pairs, if the
+  // data structure implements them.
+  template <typename ds_type>
+  void benchmark_lcs(ds_type& ds) {
+    if constexpr (requires(ds_type const& d) {
+                    d.lcs(size_t{0}, size_t{1});
+                  }) {
+      if (queries.empty()) {
+        return;
+      }
+      fmt::print("RESULT algo={}_lcs", cur_algo);
+      fmt::print(" text={}", text_path.filename().string());
+      fmt::print(" lce_range={}", cur_lce_range);
+      size_t check_sum = 0;
+      lce::util::timer t;
+      for (size_t i = 0; i < queries.size(); i += 2) {
+        check_sum += ds.lcs(queries[i], queries[i + 1]);
+      }
+      fmt::print(" q_time={}", t.get());
+      fmt::print(" check_sum={}", check_sum);
+      fmt::print("\n");
+    }
+  }
+
+  // Time lce_k_mismatch for k = 1, 2, 4, ..., k_max on the current queries,
+  // against kangaroo jumps with lce(), if the data structure implements it.
+  template <typename ds_type>
+  void benchmark_k_mismatch(ds_type& ds) {
+    if constexpr (requires(ds_type const& d) {
+                    d.lce_k_mismatch(size_t{0}, size_t{1}, size_t{1});
+                  }) {
+      const size_t size = text.size();
+      for (size_t k = 1; k <= k_max && !queries.empty(); k *= 2) {
+        fmt::print("RESULT algo={}_k_mismatch", cur_algo);
+        fmt::print(" text={}", text_path.filename().string());
+        fmt::print(" lce_range={} k={}", cur_lce_range, k);
+
+        size_t check_sum = 0;
+        lce::util::timer t;
+        for (size_t i = 0; i < queries.size(); i += 2) {
+          check_sum += ds.lce_k_mismatch(queries[i], queries[i + 1], k);
+        }
+        fmt::print(" q_time={}", t.get_and_reset());
+
+        size_t lce_check_sum = 0;
+        for (size_t i = 0; i < queries.size(); i += 2) {
+          const size_t l = std::min(queries[i], queries[i + 1]);
+          const size_t r = std::max(queries[i], queries[i + 1]);
+          size_t ext = 0;
+          for (size_t m = 0;; ++m) {
+            if (r + ext < size) {
+              ext += ds.lce(l + ext, r + ext);
+            }
+            if (r + ext == size || m == k) {
+              break;
+            }
+            ++ext;
+          }
+          lce_check_sum += ext;
+        }
+        fmt::print(" lce_time={}", t.get());
+        fmt::print(" check_sum={}", check_sum);
+        if (check_sum != lce_check_sum) {
+          fmt::print(" lce_check_sum={}", lce_check_sum);
+        }
+        fmt::print("\n");
+      }
+    }
+  }
+
+  // Report how the queries split across the cases of the sss variants and the
+  // work per query (only with LCE_QUERY_STATS).
+  void print_query_stats(size_t num) {
+    auto const& stats = lce::util::query_stats::local();
+    for (size_t c = 0; c < stats.max_cases; ++c) {
+      fmt::print(" case{}_queries={}", c, stats.cases[c]);
+    }
+    fmt::print(" scans_per_query={:.3f}", double(stats.scans) / num);
+    fmt::print(" scanned_bytes_per_query={:.1f}",
+               double(stats.scanned_bytes) / num);
+    fmt::print(" pred_per_query={:.3f}", double(stats.pred_calls) / num);
+    fmt::print(" rmq_per_query={:.3f}", double(stats.rmq_calls) / num);
+  }
+
+  // Time every query on its own and report percentiles of the latencies. For
+  // the sss variants, the latencies are additionally split by the case of
+  // lce_lr that answers the query (see lce_case), so we can tell which case
+  // produces the tail.
+  template <typename ds_type>
+  void benchmark_latency(ds_type& ds) {
+    typedef std::chrono::steady_clock clock;
+    static constexpr size_t max_cases = 4;
+    constexpr bool has_cases = requires(ds_type const& d, uint64_t& c) {
+      d.lce_case(size_t{0}, size_t{1}, c);
+    };
+
+    const uint64_t overhead = lce::util::steady_clock_overhead_ns();
+    lce::util::latency_histogram<> hist;
+    std::array<lce::util::latency_histogram<>, max_cases> case_hist;
+    uint64_t max_case = 0;
+    size_t check_sum = 0;
+    for (size_t i = 0; i < queries.size(); i += 2) {
+      uint64_t c = 0;
+      const auto begin = clock::now();
+      if constexpr (has_cases) {
+        check_sum += ds.lce_case(queries[i], queries[i + 1], c);
+      } else {
+        check_sum += ds.lce(queries[i], queries[i + 1]);
+      }
+      const auto end = clock::now();
+      uint64_t ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+              .count();
+      ns = ns > overhead ? ns - overhead : 0;
+      if constexpr (has_cases) {
+        if (ns >= hist.max()) {
+          max_case = c;
+        }
+        case_hist[c].record(ns);
+      }
+      hist.record(ns);
+    }
+
+    fmt::print(" lat_p50={}", hist.percentile(0.5));
+    fmt::print(" lat_p99={}", hist.percentile(0.99));
+    fmt::print(" lat_p999={}", hist.percentile(0.999));
+    fmt::print(" lat_max={}", hist.max());
+    fmt::print(" lat_check_sum={}", check_sum);
+    if constexpr (has_cases) {
+      fmt::print(" lat_max_case={}", max_case);
+      for (size_t c = 0; c < max_cases; ++c) {
+        if (case_hist[c].count() == 0) {
+          continue;
+        }
+        fmt::print(" case{}_count={}", c, case_hist[c].count());
+        fmt::print(" case{}_p50={}", c, case_hist[c].percentile(0.5));
+        fmt::print(" case{}_p99={}", c, case_hist[c].percentile(0.99));
+        fmt::print(" case{}_p999={}", c, case_hist[c].percentile(0.999));
+        fmt::print(" case{}_max={}", c, case_hist[c].max());
+      }
+    }
+
+    if (!latency_csv_path.empty()) {
+      write_latency_csv(hist, "all");
+      for (size_t c = 0; c < max_cases; ++c) {
+        write_latency_csv(case_hist[c], std::to_string(c));
+      }
+    }
+  }
+
+  // Append the buckets of the histogram to the csv file (one line per
+  // non-empty bucket).
+  void write_latency_csv(lce::util::latency_histogram<> const& hist,
+                         std::string const& query_case) {
+    const bool write_header = !fs::exists(latency_csv_path);
+    std::ofstream out(latency_csv_path, std::ios::app);
+    if (write_header) {
+      out << "algo,text,lce_range,case,lower_ns,upper_ns,count\n";
+    }
+    hist.for_each_bucket([&](uint64_t lower, uint64_t upper, uint64_t count) {
+      out << fmt::format("{},{},{},{},{},{},{}\n", cur_algo,
+                         text_path.filename().string(), cur_lce_range,
+                         query_case, lower, upper, count);
+    });
   }
 
   template <typename ds_type>
@@ -256,17 +507,28 @@ class benchmark {
     fmt::print("\n");
 
     // Benchmark queries
+    cur_algo = algo_name;
     size_t lce_cur = lce_from;
     while (lce_cur < lce_to) {
+      cur_lce_range = lce_cur;
       fmt::print("RESULT algo={}_queries", algo_name);
       fmt::print(" text={}", text_path.filename().string());
       fmt::print(" lce_range={}", lce_cur);
       load_queries(lce_cur);
       benchmark_queries<ds_type>(ds);
       fmt::print("\n");
+      benchmark_lcs<ds_type>(ds);
+      if (k_max != 0) {
+        benchmark_k_mismatch<ds_type>(ds);
+      }
       ++lce_cur;
     }
   }
+
+ private:
+  // the current run, for the latency csv
+  std::string cur_algo;
+  size_t cur_lce_range = 0;
 };
 
 namespace std {
@@ -305,6 +567,17 @@ int main(int argc, char** argv) {
       "to", b.lce_to,
       "Use only lce queries which return up to 2^{to}-1 with (default=21)");
 
+  cp.add_flag("latency", b.latency,
+              "Additionally time every query on its own and report latency "
+              "percentiles (per query case for the sss variants).");
+  cp.add_path("latency_csv", b.latency_csv_path,
+              "Append the latency histograms to this csv file (requires "
+              "--latency).");
+
+  cp.add_size_t("k_max", b.k_max,
+                "Additionally benchmark lce_k_mismatch for k = 1, 2, 4, ..., "
+                "k_max where it is implemented (default=0, off).");
+
   cp.add_string(
       'a', "algorithm", b.algorithm,
       fmt::format("Name of data structure which is benchmarked. Options: {}",
@@ -349,6 +622,15 @@ int main(int argc, char** argv) {
   b.run<lce_sss_noss<uint8_t, 1024, uint40_t, true>>("sss_noss1024pl");
   b.run<lce_sss_noss<uint8_t, 2048, uint40_t, true>>("sss_noss2048pl");
 
+  b.run<lce_sss_fp<uint8_t, 256, uint40_t, false>>("sss_fp256");
+  b.run<lce_sss_fp<uint8_t, 512, uint40_t, false>>("sss_fp512");
+  b.run<lce_sss_fp<uint8_t, 1024, uint40_t, false>>("sss_fp1024");
+  b.run<lce_sss_fp<uint8_t, 2048, uint40_t, false>>("sss_fp2048");
+  b.run<lce_sss_fp<uint8_t, 256, uint40_t, true>>("sss_fp256pl");
+  b.run<lce_sss_fp<uint8_t, 512, uint40_t, true>>("sss_fp512pl");
+  b.run<lce_sss_fp<uint8_t, 1024, uint40_t, true>>("sss_fp1024pl");
+  b.run<lce_sss_fp<uint8_t, 2048, uint40_t, true>>("sss_fp2048pl");
+
   b.run<lce_sss<uint8_t, 256, uint40_t, false>>("sss256");
   b.run<lce_sss<uint8_t, 512, uint40_t, false>>("sss512");
   b.run<lce_sss<uint8_t, 1024, uint40_t, false>>("sss1024");
@@ -358,6 +640,53 @@ int main(int argc, char** argv) {
   b.run<lce_sss<uint8_t, 1024, uint40_t, true>>("sss1024pl");
   b.run<lce_sss<uint8_t, 2048, uint40_t, true>>("sss2048pl");
 
+  using lce::pred::s_tree_index;
+  b.run<lce_sss<uint8_t, 256, uint40_t, false, s_tree_index<uint40_t>>>(
+      "sss256_s_tree");
+  b.run<lce_sss<uint8_t, 512, uint40_t, false, s_tree_index<uint40_t>>>(
+      "sss512_s_tree");
+  b.run<lce_sss<uint8_t, 1024, uint40_t, false, s_tree_index<uint40_t>>>(
+      "sss1024_s_tree");
+  b.run<lce_sss<uint8_t, 2048, uint40_t, false, s_tree_index<uint40_t>>>(
+      "sss2048_s_tree");
+
+  using lce::pred::elias_fano_index;
+  b.run<lce_sss<uint8_t, 256, uint40_t, false, elias_fano_index<uint40_t>>>(
+      "sss256_ef");
+  b.run<lce_sss<uint8_t, 512, uint40_t, false, elias_fano_index<uint40_t>>>(
+      "sss512_ef");
+  b.run<lce_sss<uint8_t, 1024, uint40_t, false, elias_fano_index<uint40_t>>>(
+      "sss1024_ef");
+  b.run<lce_sss<uint8_t, 2048, uint40_t, false, elias_fano_index<uint40_t>>>(
+      "sss2048_ef");
+
+  using lce::pred::radix_spline_index;
+  b.run<lce_sss<uint8_t, 256, uint40_t, false, radix_spline_index<uint40_t>>>(
+      "sss256_rs");
+  b.run<lce_sss<uint8_t, 512, uint40_t, false, radix_spline_index<uint40_t>>>(
+      "sss512_rs");
+  b.run<lce_sss<uint8_t, 1024, uint40_t, false, radix_spline_index<uint40_t>>>(
+      "sss1024_rs");
+  b.run<lce_sss<uint8_t, 2048, uint40_t, false, radix_spline_index<uint40_t>>>(
+      "sss2048_rs");
+
+  using lce::pred::compressed_sss_index;
+  b.run<lce_sss<uint8_t, 256, uint40_t, false, compressed_sss_index<uint40_t>>>(
+      "sss256_csss");
+  b.run<lce_sss<uint8_t, 512, uint40_t, false, compressed_sss_index<uint40_t>>>(
+      "sss512_csss");
+  b.run<lce_sss<uint8_t, 1024, uint40_t, false,
+                compressed_sss_index<uint40_t>>>("sss1024_csss");
+  b.run<lce_sss<uint8_t, 2048, uint40_t, false,
+                compressed_sss_index<uint40_t>>>("sss2048_csss");
+
+  b.run<lce_sss_bidirectional<uint8_t, 256, uint40_t>>("sss256_bidirectional");
+  b.run<lce_sss_bidirectional<uint8_t, 512, uint40_t>>("sss512_bidirectional");
+  b.run<lce_sss_bidirectional<uint8_t, 1024, uint40_t>>(
+      "sss1024_bidirectional");
+  b.run<lce_sss_bidirectional<uint8_t, 2048, uint40_t>>(
+      "sss2048_bidirectional");
+
   b.run<lce_classic<uint8_t, uint40_t>>("classic");
 
 #ifdef LCE_USE_SDSL
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * src/lce/benchmark_cross.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <gsaca-double-sort/uint_types.hpp>
+#include <random>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "ds/lce_cross.hpp"
+#include "ds/lce_fp.hpp"
+#include "ds/lce_sss.hpp"
+#include "util/benchmark.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+using gsaca_lyndon::uint40_t;
+
+namespace std {
+template <>
+struct hash<gsaca_lyndon::uint40_t> {
+  auto operator()(const gsaca_lyndon::uint40_t& xyz) const -> size_t {
+    return hash<uint64_t>{}(xyz.u64());
+  }
+};
+}  // namespace std
+
+std::vector<std::string> algorithms{"all", "cross_sss", "cross_fp",
+                                    "concat_sss"};
+
+struct {
+  fs::path reference_path;
+  fs::path text_path;
+  std::string algorithm = "all";
+  size_t tau = 512;
+  size_t num_queries = 1000000;
+  bool check = false;
+} options;
+
+lce::util::result_checker<std::vector<uint64_t>> checker;
+
+// Pairs (i, j) of positions in the reference and the text. Most of them are
+// aligned (i = j), which have long lce values if the text is a version of the
+// reference.
+std::vector<std::pair<size_t, size_t>> queries;
+
+template <typename query_type>
+void run_queries(query_type const& query) {
+  lce::util::timer t;
+  std::vector<uint64_t> result(queries.size());
+  for (size_t q = 0; q < queries.size(); ++q) {
+    result[q] = query(queries[q].first, queries[q].second);
+  }
+  fmt::print(" query_time={}", t.get_and_reset());
+  uint64_t sum = 0;
+  for (auto const& l : result) {
+    sum += l;
+  }
+  fmt::print(" lce_sum={}", sum);
+  if (options.check) {
+    checker.check(result);
+  }
+}
+
+void print_head(std::string const& name, std::vector<uint8_t> const& a,
+                std::vector<uint8_t> const& b) {
+  fmt::print("RESULT algo={} reference={} text={} reference_size={} "
+             "text_size={} queries={} threads={} tau={}",
+             name, options.reference_path.filename().string(),
+             options.text_path.filename().string(), a.size(), b.size(),
+             queries.size(), omp_get_max_threads(), options.tau);
+}
+
+template <uint64_t tau>
+void run(std::vector<uint8_t>& a, std::vector<uint8_t>& b) {
+  using namespace lce::ds;
+  typedef lce_cross_reference<uint8_t, tau, uint40_t> reference_type;
+  if (lce::util::is_selected(options.algorithm, "cross_sss")) {
+    print_head("cross_sss", a, b);
+    lce::util::timer t;
+    reference_type reference(a);
+    fmt::print(" reference_time={}", t.get_and_reset());
+    lce_cross_index<reference_type> index(reference, b);
+    fmt::print(" index_time={} index_mem={} anchored={}", t.get_and_reset(),
+               index.memory_breakdown().total(), index.anchored());
+    run_queries([&](size_t i, size_t j) {
+      return lce::ds::lce(reference, i, index, j);
+    });
+    fmt::print("\n");
+  }
+  if (lce::util::is_selected(options.algorithm, "cross_fp")) {
+    print_head("cross_fp", a, b);
+    lce::util::timer t;
+    lce_fp<uint8_t> reference(a);
+    fmt::print(" reference_time={}", t.get_and_reset());
+    lce_fp<uint8_t> index(b);
+    fmt::print(" index_time={} index_mem=0", t.get_and_reset());
+    run_queries([&](size_t i, size_t j) {
+      return lce::ds::lce(reference, i, index, j);
+    });
+    fmt::print("\n");
+  }
+  if (lce::util::is_selected(options.algorithm, "concat_sss")) {
+    // the baseline copies both texts and builds one index for every text
+    print_head("concat_sss", a, b);
+    lce::util::timer t;
+    std::vector<uint8_t> concat(a.size() + b.size());
+    std::copy(a.begin(), a.end(), concat.begin());
+    std::copy(b.begin(), b.end(), concat.begin() + a.size());
+    lce_sss<uint8_t, tau, uint40_t> ds(concat);
+    fmt::print(" reference_time=0 index_time={}", t.get_and_reset());
+    run_queries([&](size_t i, size_t j) {
+      return std::min(ds.lce(i, a.size() + j),
+                      std::min(a.size() - i, b.size() - j));
+    });
+    fmt::print("\n");
+  }
+}
+
+int main(int argc, char** argv) {
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program benchmarks lce queries between a reference text and a "
+      "second text, e.g. a new version of it, with an index on each text "
+      "(cross_sss, cross_fp) and with one lce_sss on their concatenation.");
+  cp.set_author("Lukas Nalbach <lukas.nalbach@tu-dortmund.de>");
+  cp.add_param_path("reference_path", options.reference_path,
+                    "The path to the reference text.");
+  cp.add_param_path("text_path", options.text_path,
+                    "The path to the second text.");
+  cp.add_string(
+      'a', "algorithm", options.algorithm,
+      fmt::format("Name of the algorithm which is benchmarked. Options: {}",
+                  algorithms));
+  cp.add_size_t('t', "tau", options.tau, lce::util::tau_description);
+  cp.add_bytes('q', "queries", options.num_queries,
+               "The number of queries (default: 1000000).");
+  cp.add_flag('c', "check", options.check,
+              "Check that all algorithms return the same lce values.");
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+
+  if (!lce::util::check_text_file(options.reference_path) ||
+      !lce::util::check_text_file(options.text_path) ||
+      !lce::util::check_algorithm(algorithms, options.algorithm)) {
+    return -1;
+  }
+
+  auto a = lce::util::load_text(options.reference_path);
+  auto b = lce::util::load_text(options.text_path);
+
+  std::mt19937_64 gen(42);
+  queries.resize(options.num_queries);
+  for (auto& [i, j] : queries) {
+    j = gen() % b.size();
+    i = (gen() % 8 == 0) ? gen() % a.size() : j % a.size();
+  }
+
+  if (!lce::util::dispatch_tau(options.tau,
+                                [&]<uint64_t tau>() { run<tau>(a, b); })) {
+    return -1;
+  }
+  return 0;
+}
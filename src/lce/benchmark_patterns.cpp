@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * src/lce/benchmark_patterns.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "ds/lce_fp.hpp"
+#include "ds/lce_naive_wordwise_xor.hpp"
+#include "util/benchmark.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+
+std::vector<std::string> algorithms{"all", "fp_pattern", "naive"};
+
+struct {
+  fs::path text_path;
+  std::string algorithm = "all";
+  size_t num_patterns = 1000;
+  size_t pattern_length = 10000;
+  size_t num_candidates = 100;
+  size_t mutations = 4;
+  bool check = false;
+} options;
+
+lce::util::result_checker<std::vector<uint64_t>> checker;
+
+// Patterns are substrings of the text with a few substitutions. The
+// candidates of a pattern are its origin, positions near it and random ones.
+struct pattern_batch {
+  std::vector<std::vector<uint8_t>> patterns;
+  std::vector<std::vector<size_t>> candidates;
+} batch;
+
+void generate_batch(std::vector<uint8_t> const& text) {
+  std::mt19937_64 gen(42);
+  const size_t m = std::min(options.pattern_length, text.size());
+  for (size_t k = 0; k < options.num_patterns; ++k) {
+    const size_t from = gen() % (text.size() - m + 1);
+    std::vector<uint8_t> p(text.begin() + from, text.begin() + from + m);
+    for (size_t x = 0; x < options.mutations && m != 0; ++x) {
+      p[gen() % m] = gen() % 256;
+    }
+    std::vector<size_t> candidates(options.num_candidates);
+    for (size_t c = 0; c < candidates.size(); ++c) {
+      candidates[c] = (c % 2 == 0)
+                          ? std::min(from + c / 2, text.size() - 1)
+                          : gen() % text.size();
+    }
+    batch.patterns.push_back(std::move(p));
+    batch.candidates.push_back(std::move(candidates));
+  }
+}
+
+void print_result(std::vector<uint64_t> const& result) {
+  uint64_t sum = 0;
+  for (auto const& l : result) {
+    sum += l;
+  }
+  fmt::print(" lce_sum={}", sum);
+  if (options.check) {
+    checker.check(result);
+  }
+  fmt::print("\n");
+}
+
+void print_head(std::string const& name, std::vector<uint8_t> const& text) {
+  fmt::print("RESULT algo={} text={} text_size={} patterns={} "
+             "pattern_length={} candidates={} threads={}",
+             name, options.text_path.filename().string(), text.size(),
+             batch.patterns.size(), options.pattern_length,
+             options.num_candidates, omp_get_max_threads());
+}
+
+// Every pattern is matched against its candidates from offset 0.
+void run_fp_pattern(std::vector<uint8_t>& text) {
+  typedef lce::ds::lce_fp<uint8_t> ds_type;
+  print_head("fp_pattern", text);
+  lce::util::timer t;
+  ds_type ds(text);
+  fmt::print(" ds_time={}", t.get_and_reset());
+
+  const size_t num = batch.patterns.size();
+  std::vector<ds_type::pattern> patterns(num);
+#pragma omp parallel for
+  for (size_t k = 0; k < num; ++k) {
+    patterns[k] = ds_type::pattern(batch.patterns[k]);
+  }
+  fmt::print(" pattern_time={}", t.get_and_reset());
+
+  std::vector<uint64_t> result(num * options.num_candidates);
+#pragma omp parallel for
+  for (size_t k = 0; k < num; ++k) {
+    for (size_t c = 0; c < options.num_candidates; ++c) {
+      result[k * options.num_candidates + c] =
+          ds.lce(patterns[k], 0, batch.candidates[k][c]);
+    }
+  }
+  fmt::print(" query_time={}", t.get_and_reset());
+  print_result(result);
+}
+
+void run_naive(std::vector<uint8_t> const& text) {
+  typedef lce::ds::lce_naive_wordwise_xor<uint8_t> naive_type;
+  print_head("naive", text);
+  fmt::print(" ds_time=0 pattern_time=0");
+  lce::util::timer t;
+  const size_t num = batch.patterns.size();
+  std::vector<uint64_t> result(num * options.num_candidates);
+#pragma omp parallel for
+  for (size_t k = 0; k < num; ++k) {
+    auto const& p = batch.patterns[k];
+    for (size_t c = 0; c < options.num_candidates; ++c) {
+      const size_t i = batch.candidates[k][c];
+      result[k * options.num_candidates + c] = naive_type::lce_cross(
+          p.data(), text.data() + i, std::min(p.size(), text.size() - i));
+    }
+  }
+  fmt::print(" query_time={}", t.get_and_reset());
+  print_result(result);
+}
+
+int main(int argc, char** argv) {
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program benchmarks lce queries between patterns given at query "
+      "time and the suffixes of a text. Each pattern is a substring of the "
+      "text with a few substitutions and is matched against its origin, "
+      "positions near it and random positions.");
+  cp.set_author("Lukas Nalbach <lukas.nalbach@tu-dortmund.de>");
+  cp.add_param_path("text_path", options.text_path, "The path to the text.");
+  cp.add_string(
+      'a', "algorithm", options.algorithm,
+      fmt::format("Name of the algorithm which is benchmarked. Options: {}",
+                  algorithms));
+  cp.add_bytes('n', "patterns", options.num_patterns,
+               "The number of patterns (default: 1000).");
+  cp.add_bytes('m', "length", options.pattern_length,
+               "The length of the patterns (default: 10000).");
+  cp.add_bytes('k', "candidates", options.num_candidates,
+               "The number of candidate positions per pattern (default: "
+               "100).");
+  cp.add_bytes('s', "substitutions", options.mutations,
+               "The number of substitutions per pattern (default: 4).");
+  cp.add_flag('c', "check", options.check,
+              "Check that all algorithms return the same lce values.");
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+
+  if (!lce::util::check_text_file(options.text_path) ||
+      !lce::util::check_algorithm(algorithms, options.algorithm)) {
+    return -1;
+  }
+
+  auto text = lce::util::load_text(options.text_path);
+  generate_batch(text);
+
+  if (lce::util::is_selected(options.algorithm, "naive")) {
+    run_naive(text);
+  }
+  if (lce::util::is_selected(options.algorithm, "fp_pattern")) {
+    run_fp_pattern(text);
+  }
+  return 0;
+}
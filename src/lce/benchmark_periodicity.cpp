@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * src/lce/benchmark_periodicity.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <gsaca-double-sort/uint_types.hpp>
+#include <random>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "ds/lce_fp.hpp"
+#include "ds/lce_naive_wordwise_xor.hpp"
+#include "ds/lce_sss.hpp"
+#include "ds/periodicity.hpp"
+#include "util/benchmark.hpp"
+#include "util/synthetic_text.hpp"
+#include "util/timer.hpp"
+
+using gsaca_lyndon::uint40_t;
+
+namespace std {
+template <>
+struct hash<gsaca_lyndon::uint40_t> {
+  auto operator()(const gsaca_lyndon::uint40_t& xyz) const -> size_t {
+    return hash<uint64_t>{}(xyz.u64());
+  }
+};
+}  // namespace std
+
+std::vector<std::string> algorithms{"all", "sss", "sss_all_candidates", "fp",
+                                    "naive"};
+
+struct {
+  std::string family = "periodic";
+  std::string algorithm = "all";
+  size_t size = 1 << 24;
+  size_t tau = 512;
+  size_t num_queries = 1000000;
+  size_t max_length = 10000;
+  size_t seed = 1;
+  bool check = false;
+} options;
+
+lce::util::result_checker<std::vector<uint64_t>> checker;
+
+// Substrings text[i, i + len). Half of them are inside the repeats of the
+// synthetic text, which have small periods.
+std::vector<std::pair<size_t, size_t>> queries;
+
+void generate_queries(lce::util::synthetic_text const& st) {
+  std::mt19937_64 gen(options.seed);
+  const size_t n = st.text.size();
+  queries.resize(options.num_queries);
+  for (size_t q = 0; q < queries.size(); ++q) {
+    size_t i = gen() % n;
+    size_t max_len = std::min(options.max_length, n - i);
+    if (q % 2 == 0 && !st.repeats.empty()) {
+      auto const& r = st.repeats[gen() % st.repeats.size()];
+      i = r.begin + gen() % (r.end - r.begin);
+      max_len = std::min(options.max_length, std::min(r.end + r.shift, n) - i);
+    }
+    queries[q] = {i, 1 + gen() % max_len};
+  }
+}
+
+template <typename query_type>
+void run_queries(std::string const& name, size_t ds_time,
+                 query_type const& query) {
+  fmt::print("RESULT algo={} family={} text_size={} queries={} "
+             "max_length={} threads={} tau={} ds_time={}",
+             name, options.family, options.size, queries.size(),
+             options.max_length, omp_get_max_threads(), options.tau, ds_time);
+  lce::util::timer t;
+  std::vector<uint64_t> result(queries.size());
+#pragma omp parallel for
+  for (size_t q = 0; q < queries.size(); ++q) {
+    result[q] = query(queries[q].first, queries[q].second);
+  }
+  fmt::print(" query_time={}", t.get_and_reset());
+  uint64_t sum = 0;
+  size_t periodic = 0;
+  for (size_t q = 0; q < queries.size(); ++q) {
+    sum += result[q];
+    periodic += 2 * result[q] <= queries[q].second;
+  }
+  fmt::print(" period_sum={} periodic={}", sum, periodic);
+  if (options.check) {
+    checker.check(result);
+  }
+  fmt::print("\n");
+}
+
+template <uint64_t tau>
+void run(std::vector<uint8_t>& text) {
+  using namespace lce::ds;
+  if (lce::util::is_selected(options.algorithm, "sss")) {
+    lce::util::timer t;
+    lce_sss<uint8_t, tau, uint40_t> ds(text);
+    run_queries("sss", t.get(), [&](size_t i, size_t len) {
+      return smallest_period(ds, i, len);
+    });
+  }
+  if (lce::util::is_selected(options.algorithm, "sss_all_candidates")) {
+    // the loop without skipping candidates or using the periodic areas
+    lce::util::timer t;
+    lce_sss<uint8_t, tau, uint40_t> ds(text);
+    run_queries("sss_all_candidates", t.get(), [&](size_t i, size_t len) {
+      size_t p = 1;
+      while (p < len && ds.lce(i, i + p) < len - p) {
+        ++p;
+      }
+      return p;
+    });
+  }
+  if (lce::util::is_selected(options.algorithm, "fp")) {
+    lce::util::timer t;
+    lce_fp<uint8_t> ds(text);
+    run_queries("fp", t.get(), [&](size_t i, size_t len) {
+      return smallest_period(ds, i, len);
+    });
+  }
+  if (lce::util::is_selected(options.algorithm, "naive")) {
+    lce_naive_wordwise_xor<uint8_t> ds(text);
+    run_queries("naive", 0, [&](size_t i, size_t len) {
+      return smallest_period(ds, i, len);
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program benchmarks smallest period queries on substrings of a "
+      "synthetic text (see gen_text) with LCE data structures. Half of the "
+      "substrings are inside repeats of the text.");
+  cp.set_author("Lukas Nalbach <lukas.nalbach@tu-dortmund.de>");
+  cp.add_string('f', "family", options.family,
+                fmt::format("The family of the synthetic text. Options: {} "
+                            "(default: periodic).",
+                            lce::util::synthetic_families));
+  cp.add_string(
+      'a', "algorithm", options.algorithm,
+      fmt::format("Name of the algorithm which is benchmarked. Options: {}",
+                  algorithms));
+  cp.add_bytes('n', "size", options.size,
+               "The size of the text, a multiple of 8 (default: 16Mi).");
+  cp.add_size_t('t', "tau", options.tau, lce::util::tau_description);
+  cp.add_bytes('q', "queries", options.num_queries,
+               "The number of queries (default: 1000000).");
+  cp.add_bytes('m', "length", options.max_length,
+               "The maximum length of the substrings (default: 10000).");
+  cp.add_size_t('s', "seed", options.seed, "The seed (default: 1).");
+  cp.add_flag('c', "check", options.check,
+              "Check that all algorithms return the same periods.");
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+
+  if (!lce::util::is_synthetic_family(options.family)) {
+    fmt::print("Family {} is not specified.\n Use one of {}\n", options.family,
+               lce::util::synthetic_families);
+    return -1;
+  }
+  if (!lce::util::check_algorithm(algorithms, options.algorithm)) {
+    return -1;
+  }
+  // lce_fp needs a multiple of 8 symbols
+  options.size = std::max<size_t>(options.size / 8 * 8, 8 * options.tau);
+
+  auto st = lce::util::generate_synthetic_text(options.family, options.size,
+                                               options.seed);
+  generate_queries(st);
+
+  if (!lce::util::dispatch_tau(options.tau,
+                                [&]<uint64_t tau>() { run<tau>(st.text); })) {
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * src/lce/benchmark_runs.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <gsaca-double-sort/uint_types.hpp>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "ds/lce_fp.hpp"
+#include "ds/lce_sss.hpp"
+#include "ds/lce_sss_bidirectional.hpp"
+#include "ds/runs.hpp"
+#include "util/benchmark.hpp"
+#include "util/io.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+using gsaca_lyndon::uint40_t;
+
+namespace std {
+template <>
+struct hash<gsaca_lyndon::uint40_t> {
+  auto operator()(const gsaca_lyndon::uint40_t& xyz) const -> size_t {
+    return hash<uint64_t>{}(xyz.u64());
+  }
+};
+}  // namespace std
+
+std::vector<std::string> algorithms{"all", "runs_sss", "runs_sss_copy",
+                                    "runs_fp"};
+
+struct {
+  fs::path text_path;
+  fs::path out_path;
+  std::string algorithm = "all";
+  size_t tau = 512;
+  size_t prefix_size = std::numeric_limits<size_t>::max();
+  bool check = false;
+} options;
+
+lce::util::result_checker<std::vector<lce::ds::run>> checker;
+
+template <typename ds_type>
+void run_runs(std::string const& name, std::vector<uint8_t>& text) {
+  fmt::print("RESULT algo={} text={} text_size={} threads={} tau={}", name,
+             options.text_path.filename().string(), text.size(),
+             omp_get_max_threads(), options.tau);
+  lce::util::timer t;
+  ds_type ds(text);
+  fmt::print(" ds_time={}", t.get_and_reset());
+
+  const auto runs = lce::ds::compute_runs<uint40_t>(ds, text);
+  fmt::print(" runs_time={}", t.get_and_reset());
+
+  const auto bytes = lce::ds::encode_runs(runs);
+  fmt::print(" encode_time={}", t.get_and_reset());
+  fmt::print(" runs={} runs_bytes={}", runs.size(), bytes.size());
+  if (!options.out_path.empty() && !checker.has_reference()) {
+    lce::util::write_vector(options.out_path, bytes);
+  }
+
+  if (options.check) {
+    checker.check(runs);
+  }
+  fmt::print("\n");
+}
+
+template <uint64_t tau>
+void run(std::vector<uint8_t>& text) {
+  using namespace lce::ds;
+  if (lce::util::is_selected(options.algorithm, "runs_sss")) {
+    run_runs<lce_sss_bidirectional<uint8_t, tau, uint40_t>>("runs_sss", text);
+  }
+  if (lce::util::is_selected(options.algorithm, "runs_sss_copy")) {
+    run_runs<runs::with_reversed_copy<lce_sss<uint8_t, tau, uint40_t>>>(
+        "runs_sss_copy", text);
+  }
+  if (lce::util::is_selected(options.algorithm, "runs_fp")) {
+    run_runs<runs::with_reversed_copy<lce_fp<uint8_t>>>("runs_fp", text);
+  }
+}
+
+int main(int argc, char** argv) {
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program benchmarks the computation of all runs (maximal "
+      "repetitions) of a text with LCE data structures. The runs are "
+      "written as varints (distance to the previous start, period and length "
+      "minus twice the period).");
+  cp.set_author("Lukas Nalbach <lukas.nalbach@tu-dortmund.de>");
+  cp.add_param_path("text_path", options.text_path, "The path to the text.");
+  cp.add_path('o', "out", options.out_path,
+              "Write the runs of the first algorithm to this file.");
+  cp.add_string(
+      'a', "algorithm", options.algorithm,
+      fmt::format("Name of the algorithm which is benchmarked. Options: {}",
+                  algorithms));
+  cp.add_size_t('t', "tau", options.tau, lce::util::tau_description);
+  cp.add_bytes('p', "prefix", options.prefix_size,
+               "Only use a prefix of the text.");
+  cp.add_flag('c', "check", options.check,
+              "Check that all algorithms find the same runs.");
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+
+  if (!lce::util::check_text_file(options.text_path) ||
+      !lce::util::check_algorithm(algorithms, options.algorithm)) {
+    return -1;
+  }
+
+  auto text = lce::util::load_text(options.text_path, options.prefix_size);
+
+  if (!lce::util::dispatch_tau(options.tau,
+                                [&]<uint64_t tau>() { run<tau>(text); })) {
+    return -1;
+  }
+  return 0;
+}
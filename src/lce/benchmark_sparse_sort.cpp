@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * src/lce/benchmark_sparse_sort.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <gsaca-double-sort/uint_types.hpp>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "ds/lce_fp.hpp"
+#include "ds/lce_sss.hpp"
+#include "ds/sparse_suffix_sort.hpp"
+#include "util/benchmark.hpp"
+#include "util/io.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+using gsaca_lyndon::uint40_t;
+
+namespace std {
+template <>
+struct hash<gsaca_lyndon::uint40_t> {
+  auto operator()(const gsaca_lyndon::uint40_t& xyz) const -> size_t {
+    return hash<uint64_t>{}(xyz.u64());
+  }
+};
+}  // namespace std
+
+std::vector<std::string> algorithms{"all", "sparse_sss", "sparse_fp",
+                                    "std_sort_sss"};
+
+struct {
+  fs::path text_path;
+  fs::path positions_path;
+  std::string algorithm = "all";
+  size_t tau = 512;
+  size_t num_positions = std::numeric_limits<size_t>::max();
+  bool lcp = false;
+  bool check = false;
+} options;
+
+lce::util::result_checker<std::vector<uint40_t>> checker;
+
+template <typename ds_type>
+void run_sparse(std::string const& name, std::vector<uint8_t>& text,
+                std::vector<uint40_t> const& positions) {
+  fmt::print("RESULT algo={} text={} positions={} threads={} tau={} lcp={}",
+             name, options.text_path.filename().string(), positions.size(),
+             omp_get_max_threads(), options.tau, options.lcp);
+  lce::util::timer t;
+  ds_type ds(text);
+  fmt::print(" ds_time={}", t.get_and_reset());
+
+  std::vector<uint40_t> sorted = positions;
+  std::vector<uint40_t> lcp;
+  lce::ds::sparse_suffix_sort(ds, text, sorted,
+                              options.lcp ? &lcp : nullptr);
+  fmt::print(" sort_time={}", t.get_and_reset());
+  if (options.check) {
+    checker.check(sorted);
+  }
+  fmt::print("\n");
+}
+
+template <typename ds_type>
+void run_std_sort(std::string const& name, std::vector<uint8_t>& text,
+                  std::vector<uint40_t> const& positions) {
+  fmt::print("RESULT algo={} text={} positions={} threads=1 tau={} lcp=false",
+             name, options.text_path.filename().string(), positions.size(),
+             options.tau);
+  lce::util::timer t;
+  ds_type ds(text);
+  fmt::print(" ds_time={}", t.get_and_reset());
+
+  std::vector<uint40_t> sorted = positions;
+  std::sort(sorted.begin(), sorted.end(),
+            [&](uint40_t const& a, uint40_t const& b) {
+              return a != b && ds.is_leq_suffix(a, b);
+            });
+  fmt::print(" sort_time={}", t.get_and_reset());
+  if (options.check) {
+    checker.check(sorted);
+  }
+  fmt::print("\n");
+}
+
+template <uint64_t tau>
+void run(std::vector<uint8_t>& text, std::vector<uint40_t> const& positions) {
+  typedef lce::ds::lce_sss<uint8_t, tau, uint40_t> sss_type;
+  if (lce::util::is_selected(options.algorithm, "sparse_sss")) {
+    run_sparse<sss_type>("sparse_sss", text, positions);
+  }
+  if (lce::util::is_selected(options.algorithm, "sparse_fp")) {
+    run_sparse<lce::ds::lce_fp<uint8_t>>("sparse_fp", text, positions);
+  }
+  if (lce::util::is_selected(options.algorithm, "std_sort_sss")) {
+    run_std_sort<sss_type>("std_sort_sss", text, positions);
+  }
+}
+
+int main(int argc, char** argv) {
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program benchmarks sparse suffix sorting with LCE data "
+      "structures. It sorts the suffixes at the positions in a file written "
+      "by gen_sss (or any file of 40-bit positions) with sparse_suffix_sort "
+      "and with std::sort and is_leq_suffix as comparator.");
+  cp.set_author("Lukas Nalbach <lukas.nalbach@tu-dortmund.de>");
+  cp.add_param_path("text_path", options.text_path, "The path to the text.");
+  cp.add_param_path("positions_path", options.positions_path,
+                    "The positions to sort, e.g. the output of gen_sss.");
+  cp.add_string(
+      'a', "algorithm", options.algorithm,
+      fmt::format("Name of the algorithm which is benchmarked. Options: {}",
+                  algorithms));
+  cp.add_size_t('t', "tau", options.tau, lce::util::tau_description);
+  cp.add_bytes('n', "num_positions", options.num_positions,
+               "Only sort a prefix of the positions.");
+  cp.add_flag('l', "lcp", options.lcp,
+              "Also compute the sparse LCP array.");
+  cp.add_flag('c', "check", options.check,
+              "Check that all algorithms return the same order.");
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Check parameters
+  if (!lce::util::check_text_file(options.text_path) ||
+      !lce::util::check_algorithm(algorithms, options.algorithm)) {
+    return -1;
+  }
+
+  // the text is padded like in benchmark_lce
+  auto text = lce::util::load_text(
+      options.text_path, std::numeric_limits<size_t>::max(), 4096 * 4);
+  const auto positions = lce::util::load_vector<uint40_t>(
+      options.positions_path, options.num_positions);
+  if (positions.empty()) {
+    fmt::print("Position file {} is empty or does not exist.\n",
+               options.positions_path.string());
+    return -1;
+  }
+  for (auto const& p : positions) {
+    if (p >= text.size()) {
+      fmt::print("Position {} is out of range.\n", uint64_t(p));
+      return -1;
+    }
+  }
+
+  if (!lce::util::dispatch_tau(
+          options.tau, [&]<uint64_t tau>() { run<tau>(text, positions); })) {
+    return -1;
+  }
+  return 0;
+}
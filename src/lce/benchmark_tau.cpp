@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * src/lce/benchmark_tau.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <gsaca-double-sort/uint_types.hpp>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "ds/lce_sss_dynamic.hpp"
+#include "util/io.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+using gsaca_lyndon::uint40_t;
+
+namespace std {
+template <>
+struct hash<gsaca_lyndon::uint40_t> {
+  auto operator()(const gsaca_lyndon::uint40_t& xyz) const -> size_t {
+    return hash<uint64_t>{}(xyz.u64());
+  }
+};
+}  // namespace std
+
+struct {
+  fs::path text_path;
+  fs::path queries_path;
+  size_t lce_from = 0;
+  size_t lce_to = 20;
+  size_t queries_per_range = 10000;
+  size_t memory_budget = std::numeric_limits<size_t>::max();
+  size_t sample_size = size_t{1} << 22;
+  bool measure = false;
+} options;
+
+typedef lce::ds::lce_sss_dynamic<uint8_t, uint40_t> ds_type;
+
+// The first queries_per_range pairs of every query file lce_{from..to - 1}
+// (see gen_queries), so the sample has the lce distribution of the ranges.
+std::vector<size_t> load_queries() {
+  std::vector<size_t> queries;
+  for (size_t r = options.lce_from; r < options.lce_to; ++r) {
+    fs::path path = options.queries_path;
+    path.append(fmt::format("lce_{}", r));
+    if (!fs::is_regular_file(path)) {
+      continue;
+    }
+    auto range = lce::util::load_vector<size_t>(path);
+    range.resize(std::min(range.size(), 2 * options.queries_per_range) / 2 *
+                 2);
+    queries.insert(queries.end(), range.begin(), range.end());
+  }
+  return queries;
+}
+
+int main(int argc, char** argv) {
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program chooses tau for lce_sss_dynamic from a sample of the text "
+      "and of the queries (see gen_queries) within a memory budget. With "
+      "--measure, the index is built for every tau and the sampled queries "
+      "are timed to compare the estimates with.");
+  cp.set_author("Lukas Nalbach <lukas.nalbach@tu-dortmund.de>");
+  cp.add_param_path("text_path", options.text_path, "The path to the text.");
+  cp.add_path("queries_path", options.queries_path,
+              "The path to the generated queries (default: "
+              "text_path.remove_filename()).");
+  cp.add_bytes("from", options.lce_from,
+               "Use only lce queries which return at least 2^{from} "
+               "(default: 0).");
+  cp.add_bytes("to", options.lce_to,
+               "Use only lce queries which return up to 2^{to}-1 (default: "
+               "20).");
+  cp.add_bytes('q', "queries", options.queries_per_range,
+               "The number of sampled queries per lce range (default: "
+               "10000).");
+  cp.add_bytes('m', "memory", options.memory_budget,
+               "The memory budget of the index (default: unlimited).");
+  cp.add_bytes('s', "sample", options.sample_size,
+               "The number of letters of the text sample (default: 4Mi).");
+  cp.add_flag("measure", options.measure,
+              "Build the index for every tau and time the sampled queries.");
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+
+  if (!fs::is_regular_file(options.text_path) ||
+      fs::file_size(options.text_path) == 0) {
+    fmt::print("Text file {} is empty or does not exist.\n",
+               options.text_path.string());
+    return -1;
+  }
+  if (options.queries_path.empty()) {
+    options.queries_path = options.text_path;
+    options.queries_path.remove_filename();
+  }
+
+  auto text = lce::util::load_vector<uint8_t>(options.text_path);
+  const auto queries = load_queries();
+  if (queries.empty()) {
+    fmt::print("No queries in {}.\n", options.queries_path.string());
+    return -1;
+  }
+
+  lce::util::timer t;
+  const auto tuning = ds_type::auto_tune(text, queries, options.memory_budget,
+                                         options.sample_size);
+  const size_t tune_time = t.get_and_reset();
+
+  for (auto const& e : tuning.estimates) {
+    fmt::print("RESULT algo=estimate text={} text_size={} queries={} "
+               "threads={} tau={} density={} run_share={} est_bytes={} "
+               "est_query_ns={:.1f}",
+               options.text_path.filename().string(), text.size(),
+               queries.size() / 2, omp_get_max_threads(), e.tau, e.density,
+               e.run_share, e.bytes, e.query_ns);
+    if (options.measure) {
+      t.reset();
+      ds_type ds(text, e.tau);
+      fmt::print(" c_time={} bytes={}", t.get_and_reset(),
+                 ds.memory_breakdown().total());
+      // the sample is repeated until the time can be measured
+      size_t rounds = 0;
+      size_t check_sum = 0;
+      while (rounds == 0 || t.get() < 200) {
+        check_sum = 0;
+        for (size_t q = 0; q < queries.size(); q += 2) {
+          check_sum += ds.lce(queries[q], queries[q + 1]);
+        }
+        ++rounds;
+      }
+      fmt::print(" query_ns={:.1f} check_sum={}",
+                 double(t.get()) * 1e6 / (rounds * queries.size() / 2),
+                 check_sum);
+    }
+    fmt::print("\n");
+  }
+  fmt::print("RESULT algo=auto_tune text={} text_size={} queries={} "
+             "threads={} memory_budget={} tune_time={} tau={}\n",
+             options.text_path.filename().string(), text.size(),
+             queries.size() / 2, omp_get_max_threads(), options.memory_budget,
+             tune_time, tuning.tau);
+  return 0;
+}
@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * src/lce/gen_queries_sss.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <gsaca-double-sort/uint_types.hpp>
+#include <ips4o.hpp>
+#include <random>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "ds/lce_sss.hpp"
+#include "util/io.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+using gsaca_lyndon::uint40_t;
+
+namespace std {
+template <>
+struct hash<gsaca_lyndon::uint40_t> {
+  auto operator()(const gsaca_lyndon::uint40_t& xyz) const -> size_t {
+    return hash<uint64_t>{}(xyz.u64());
+  }
+};
+}  // namespace std
+
+static constexpr size_t max_lce_exp = 20;
+
+struct {
+  fs::path text_path;
+  fs::path out_dir;
+  size_t tau = 512;
+  size_t sample_rate = 256;
+  size_t limit = 100'000;
+  size_t seed = 42;
+} options;
+
+// Sample the positions whose window of window_size symbols has a hash that is
+// 0 modulo the sample rate. Equal windows are sampled together, so two
+// occurrences of a repeat of length >> sample_rate contain a common sampled
+// window with high probability. The result is sorted by (hash, position).
+static constexpr size_t window_size = 32;
+
+inline uint64_t window_hash(uint8_t const* window) {
+  uint64_t hash = 0;
+  for (size_t k = 0; k < window_size; k += 8) {
+    uint64_t word;
+    std::memcpy(&word, window + k, sizeof(word));
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 32;
+  }
+  return hash;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> sample_windows(
+    std::vector<uint8_t> const& text) {
+  const size_t num_windows =
+      text.size() < window_size ? 0 : text.size() - window_size + 1;
+  std::vector<std::vector<std::pair<uint64_t, uint64_t>>> samples(
+      omp_get_max_threads());
+#pragma omp parallel
+  {
+    const int t = omp_get_thread_num();
+    const int nt = omp_get_num_threads();
+    const size_t slice_size = num_windows / nt;
+    const size_t begin = t * slice_size;
+    const size_t end = (t < nt - 1) ? (t + 1) * slice_size : num_windows;
+    for (size_t i = begin; i < end; ++i) {
+      const uint64_t hash = window_hash(text.data() + i);
+      if ((hash >> 32) % options.sample_rate == 0) {
+        samples[t].emplace_back(hash, i);
+      }
+    }
+  }
+
+  std::vector<std::pair<uint64_t, uint64_t>> result;
+  for (auto& s : samples) {
+    result.insert(result.end(), s.begin(), s.end());
+    std::vector<std::pair<uint64_t, uint64_t>>().swap(s);
+  }
+  ips4o::parallel::sort(result.begin(), result.end());
+  return result;
+}
+
+// Candidates are random pairs of positions and pairs of samples with the same
+// window. A pair (i, j) with lce l yields a query with any lce t <= l, namely
+// (i + l - t, j + l - t), which is used for the buckets that are not full.
+template <typename ds_type>
+std::array<std::vector<size_t>, max_lce_exp + 1> generate_queries(
+    std::vector<uint8_t> const& text) {
+  lce::util::timer t;
+  ds_type ds(text);
+  fmt::print(" ds_time={}", t.get_and_reset());
+
+  const auto samples = sample_windows(text);
+  // groups of at least two samples with the same window
+  std::vector<size_t> groups;
+  for (size_t i = 0; i + 1 < samples.size(); ++i) {
+    if (samples[i].first == samples[i + 1].first &&
+        (i == 0 || samples[i - 1].first != samples[i].first)) {
+      groups.push_back(i);
+    }
+  }
+  fmt::print(" samples={} groups={} sample_time={}", samples.size(),
+             groups.size(), t.get_and_reset());
+
+  std::array<std::vector<size_t>, max_lce_exp + 1> queries;
+  std::mt19937_64 gen(options.seed);
+  std::uniform_int_distribution<size_t> pos(0, text.size() - 1);
+  std::uniform_int_distribution<size_t> group(
+      0, std::max<size_t>(groups.size(), 1) - 1);
+  auto add = [&](size_t x, size_t i, size_t j) {
+    queries[x].push_back(i);
+    queries[x].push_back(j);
+  };
+  auto full = [&](size_t x) { return queries[x].size() >= 2 * options.limit; };
+
+  const size_t max_candidates = 64 * options.limit * (max_lce_exp + 1);
+  std::vector<size_t> open;
+  for (size_t c = 0; c < max_candidates; ++c) {
+    if (groups.empty() || (c & 3) == 0) {
+      const size_t i = pos(gen);
+      const size_t j = pos(gen);
+      if (i == j) {
+        continue;
+      }
+      const size_t x =
+          std::min<size_t>(std::bit_width(ds.lce(i, j)), max_lce_exp);
+      if (!full(x)) {
+        add(x, i, j);
+      }
+      if ((c & 1023) == 0) {
+        size_t num_full = 0;
+        for (size_t y = 0; y <= max_lce_exp; ++y) {
+          num_full += full(y);
+        }
+        if (num_full == max_lce_exp + 1) {
+          break;
+        }
+      }
+      continue;
+    }
+
+    // two random samples of a random group
+    const size_t g = groups[group(gen)];
+    size_t g_end = g + 1;
+    while (g_end < samples.size() && samples[g_end].first == samples[g].first) {
+      ++g_end;
+    }
+    std::uniform_int_distribution<size_t> member(g, g_end - 1);
+    const size_t i = samples[member(gen)].second;
+    const size_t j = samples[member(gen)].second;
+    if (i == j) {
+      continue;
+    }
+    const size_t l = ds.lce(i, j);
+
+    // bucket 0 is filled by the random pairs, a shift by l may leave the text
+    open.clear();
+    for (size_t x = 1; x <= std::min<size_t>(std::bit_width(l), max_lce_exp);
+         ++x) {
+      if (!full(x)) {
+        open.push_back(x);
+      }
+    }
+    if (open.empty()) {
+      continue;
+    }
+    const size_t x = open[std::uniform_int_distribution<size_t>(
+        0, open.size() - 1)(gen)];
+    const size_t lo = size_t{1} << (x - 1);
+    const size_t hi = (x == max_lce_exp) ? l : std::min(l, (size_t{1} << x) - 1);
+    const size_t target = std::uniform_int_distribution<size_t>(lo, hi)(gen);
+    add(x, i + l - target, j + l - target);
+  }
+  fmt::print(" query_time={}", t.get_and_reset());
+  return queries;
+}
+
+int main(int argc, char** argv) {
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program generates LCE queries for the benchmarks like "
+      "gen_queries, but without a suffix and LCP array. It answers candidate "
+      "queries with lce_sss, so it needs little more memory than the text and "
+      "the index.");
+  cp.set_author("Lukas Nalbach <lukas.nalbach@tu-dortmund.de>");
+  cp.add_param_path("file", options.text_path,
+                    "The text to generate queries for.");
+  cp.add_path('o', "out", options.out_dir,
+              "The output directory (default: directory of the text)");
+  cp.add_size_t('t', "tau", options.tau,
+                "Tau of lce_sss. Options: 256, 512, 1024, 2048 (default: "
+                "512).");
+  cp.add_size_t('r', "sample_rate", options.sample_rate,
+                "Sample one of about this many positions to find repeats "
+                "(default: 256).");
+  cp.add_bytes('l', "limit", options.limit,
+               "The maximum number of queries to generate per lce length "
+               "(default: 100,000).");
+  cp.add_size_t('s', "seed", options.seed, "The seed of the queries.");
+  if (!cp.process(argc, argv)) {
+    return -1;
+  }
+
+  if (!fs::is_regular_file(options.text_path) ||
+      fs::file_size(options.text_path) == 0) {
+    fmt::print("Text file {} is empty or does not exist.\n",
+               options.text_path.string());
+    return -1;
+  }
+  if (options.sample_rate == 0 || options.limit == 0) {
+    fmt::print("sample_rate and limit must be positive.\n");
+    return -1;
+  }
+  if (options.out_dir.empty()) {
+    options.out_dir = options.text_path.parent_path();
+  }
+
+  // the text is padded like in benchmark_lce, so the queries match
+  lce::util::timer t;
+  const auto text = lce::util::load_vector<uint8_t>(
+      options.text_path, std::numeric_limits<size_t>::max(), 4096 * 4, 8);
+  fmt::print("RESULT text={} text_size={} text_time={}",
+             options.text_path.filename().string(), text.size(), t.get());
+
+  std::array<std::vector<size_t>, max_lce_exp + 1> queries;
+  if (options.tau == 256) {
+    queries = generate_queries<lce::ds::lce_sss<uint8_t, 256, uint40_t>>(text);
+  } else if (options.tau == 512) {
+    queries = generate_queries<lce::ds::lce_sss<uint8_t, 512, uint40_t>>(text);
+  } else if (options.tau == 1024) {
+    queries = generate_queries<lce::ds::lce_sss<uint8_t, 1024, uint40_t>>(text);
+  } else if (options.tau == 2048) {
+    queries = generate_queries<lce::ds::lce_sss<uint8_t, 2048, uint40_t>>(text);
+  } else {
+    fmt::print("\nUnsupported tau {}.\n", options.tau);
+    return -1;
+  }
+
+  for (size_t x = 0; x <= max_lce_exp; ++x) {
+    lce::util::write_vector(options.out_dir / fmt::format("lce_{}", x),
+                            queries[x]);
+    fmt::print(" lce_{}={}", x, queries[x].size() / 2);
+  }
+  fmt::print("\n");
+  return 0;
+}
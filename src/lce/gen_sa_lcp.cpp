@@ -1,11 +1,26 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <bit>
 #include <iostream>
 #include <climits>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <vector>
 #include <filesystem>
 #include <omp.h>
+#include <tlx/cmdline_parser.hpp>
 #include "libsais64.h"
 
+struct {
+    std::string file_text;
+    std::string file_sa;
+    std::string file_lcp;
+    uint width = 5;
+    size_t bufsize = 1024 * 1024;
+} options;
+
 template <typename T>
 void read_from_file(std::istream& in, T* data, uint64_t size) {
     uint64_t size_left = size;
@@ -18,33 +33,94 @@ void read_from_file(std::istream& in, T* data, uint64_t size) {
     }
 }
 
+// Write get(0), ..., get(n - 1) with options.width bytes each. The threads
+// pack blocks of options.bufsize entries into their own buffer and write
+// them with pwrite at their final offset, so there is no single-entry write
+// and no shared file position.
+template <typename F>
+bool write_packed(int fd, int64_t n, F&& get) {
+    static_assert(std::endian::native == std::endian::little);
+    int64_t const block_size = options.bufsize;
+    int64_t const num_blocks = (n + block_size - 1) / block_size;
+    bool ok = true;
+
+#pragma omp parallel
+    {
+        auto buf = std::make_unique<char[]>(block_size * options.width);
+#pragma omp for schedule(dynamic)
+        for (int64_t b = 0; b < num_blocks; b++) {
+            int64_t const begin = b * block_size;
+            int64_t const end = std::min(begin + block_size, n);
+            char* p = buf.get();
+            for (int64_t i = begin; i < end; i++) {
+                uint64_t const value = get(i);
+                std::memcpy(p, &value, options.width);
+                p += options.width;
+            }
+
+            size_t const bytes = (end - begin) * options.width;
+            size_t written = 0;
+            while (written < bytes) {
+                ssize_t const r = pwrite(fd, buf.get() + written, bytes - written,
+                                         begin * options.width + written);
+                if (r <= 0) {
+#pragma omp atomic write
+                    ok = false;
+                    break;
+                }
+                written += r;
+            }
+        }
+    }
+    return ok;
+}
+
 int main(int argc, char *argv[]) {
-    if(argc != 4) {
-        std::cout << "invalid input, usage: <input_file> <sa_file> <lcp_file>" << std::endl;
+    tlx::CmdlineParser cp;
+    cp.set_description(
+        "This program writes the suffix and LCP array of a text for "
+        "gen_queries. Both are written in blocks straight from the suffix "
+        "and PLCP array, so the peak memory is 17n bytes.");
+    cp.add_param_string("input_file", options.file_text, "The text.");
+    cp.add_param_string("sa_file", options.file_sa,
+                        "The output file of the suffix array.");
+    cp.add_param_string("lcp_file", options.file_lcp,
+                        "The output file of the LCP array.");
+    cp.add_uint('w', "width", options.width,
+                "The number of bytes per suffix and LCP array entry "
+                "(default: 5).");
+    cp.add_bytes('b', "bufsize", options.bufsize,
+                 "The size of the write buffer of each thread in # of "
+                 "entries (default: 1Mi)");
+    if (!cp.process(argc, argv)) {
         return -1;
     }
 
-    std::ifstream input_file(argv[1]);
-    std::ofstream sa_file(argv[2]);
-    std::ofstream lcp_file(argv[3]);
+    if (options.width < 1 || options.width > 8 || options.bufsize == 0) {
+        std::cout << "invalid input: width must be in [1, 8] and bufsize positive" << std::endl;
+        return -1;
+    }
 
+    std::ifstream input_file(options.file_text);
     if(!input_file.good()) {
         std::cout << "invalid input: could not read <input_file>" << std::endl;
         return -1;
     }
 
-    if(!sa_file.is_open()) {
+    int const sa_fd = open(options.file_sa.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(sa_fd < 0) {
         std::cout << "invalid input: could not create <sa_file>" << std::endl;
         return -1;
     }
 
-    if(!lcp_file.is_open()) {
+    int const lcp_fd = open(options.file_lcp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(lcp_fd < 0) {
         std::cout << "invalid input: could not create <lcp_file>" << std::endl;
         return -1;
     }
 
     std::cout << "reading T" << std::endl;
-	int64_t n = std::filesystem::file_size(argv[1]) + 1;
+    int64_t n = std::filesystem::file_size(options.file_text) + 1;
     std::vector<uint8_t> T(n);
     read_from_file(input_file, T.data(), n - 1);
     T[n - 1] = 1;
@@ -56,20 +132,22 @@ int main(int argc, char *argv[]) {
     std::cout << "building PLCP" << std::endl;
     std::vector<int64_t> PLCP(n);
     libsais64_plcp_omp(T.data(), SA.data(), PLCP.data(), n, omp_get_max_threads());
-
-    std::cout << "building LCP" << std::endl;
-    std::vector<int64_t> LCP(n);
-    libsais64_lcp_omp(PLCP.data(), SA.data(), LCP.data(), n, omp_get_max_threads());
+    std::vector<uint8_t>().swap(T);
 
     std::cout << "writing SA to <sa_file>" << std::endl;
-    for (int64_t i = 0; i < n; i++) {
-        sa_file.write((char*) &SA[i], 5);
+    if (!write_packed(sa_fd, n, [&](int64_t i) { return SA[i]; })) {
+        std::cout << "could not write <sa_file>" << std::endl;
+        return -1;
     }
+    close(sa_fd);
 
+    // LCP[i] = PLCP[SA[i]] is computed while packing, there is no LCP array
     std::cout << "writing LCP to <lcp_file>" << std::endl;
-    for (int64_t i = 0; i < n; i++) {
-        lcp_file.write((char*) &LCP[i], 5);
+    if (!write_packed(lcp_fd, n, [&](int64_t i) { return PLCP[SA[i]]; })) {
+        std::cout << "could not write <lcp_file>" << std::endl;
+        return -1;
     }
-    
+    close(lcp_fd);
+
     return 0;
-}
\ No newline at end of file
+}
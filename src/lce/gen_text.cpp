@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * src/lce/gen_text.cpp
+ *
+ * Copyright (C) 2026 Lukas Nalbach <lukas.nalbach@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <filesystem>
+#include <tlx/cmdline_parser.hpp>
+
+#include "util/io.hpp"
+#include "util/synthetic_text.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+  std::string family;
+  size_t size = size_t{1} << 26;
+  size_t seed = 42;
+  size_t limit = 100'000;
+  fs::path output_path;
+
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program writes a synthetic text and LCE queries for it (in the "
+      "format of gen_queries), so benchmark_lce can run without external "
+      "data. The text is written to <output_folder>/text.");
+  cp.add_param_string(
+      "family", family,
+      fmt::format("The family of the text. Options: {}",
+                  lce::util::synthetic_families));
+  cp.add_bytes('n', "size", size, "The size of the text (default: 64Mi).");
+  cp.add_size_t('s', "seed", seed, "The seed of the text and the queries.");
+  cp.add_bytes('l', "limit", limit,
+               "The maximum number of queries per lce length, 0 writes no "
+               "queries (default: 100,000).");
+  cp.add_path('o', "output_folder", output_path,
+              "The output folder (default: ./<family>).");
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Check parameters
+  if (!lce::util::is_synthetic_family(family)) {
+    fmt::print("Unknown family {}. Options: {}\n", family,
+               lce::util::synthetic_families);
+    return -1;
+  }
+  if (output_path.empty()) {
+    output_path = family;
+  }
+  fs::create_directories(output_path);
+
+  lce::util::timer t;
+  fmt::print("RESULT family={} size={} seed={}", family, size, seed);
+  auto st = lce::util::generate_synthetic_text(family, size, seed);
+  lce::util::write_vector(output_path / "text", st.text);
+  fmt::print(" text_time={} repeats={}", t.get_and_reset(), st.repeats.size());
+
+  if (limit != 0) {
+    auto queries = lce::util::generate_synthetic_queries(st, limit, seed + 1);
+    for (size_t x = 0; x < queries.size(); ++x) {
+      lce::util::write_vector(output_path / fmt::format("lce_{}", x),
+                              queries[x]);
+      fmt::print(" lce_{}={}", x, queries[x].size() / 2);
+    }
+    fmt::print(" queries_time={}", t.get_and_reset());
+  }
+  fmt::print("\n");
+  return 0;
+}
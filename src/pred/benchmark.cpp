@@ -25,12 +25,17 @@
 #include <tlx/cmdline_parser.hpp>
 #include <vector>
 
+#include "pred/adaptive_pred_index.hpp"
 #include "pred/binsearch_std.hpp"
 #include "pred/binsearch_cache.hpp"
+#include "pred/compressed_sss_index.hpp"
+#include "pred/elias_fano_index.hpp"
 #include "pred/rank_index.hpp"
 #include "pred/j_index.hpp"
 #include "pred/pgm_index.hpp"
 #include "pred/pred_index.hpp"
+#include "pred/radix_spline_index.hpp"
+#include "pred/s_tree_index.hpp"
 
 #ifdef LCE_USE_SDSL
 #include "pred/sd_array_index.hpp"
@@ -41,17 +46,32 @@
 #endif
 
 #include "util/io.hpp"
+#include "util/latency_histogram.hpp"
+#ifdef LCE_BENCHMARK_PERF
+#include "util/perf_counters.hpp"
+#endif
 #include "util/timer.hpp"
 
 namespace fs = std::filesystem;
 
 std::vector<std::string> algorithms{
-  "all", "binsearch_std", "binsearch_cache", "rank_index", "pred_index", "j_index", "pgm",
+  "all", "binsearch_std", "binsearch_cache", "rank_index", "j_index", "pgm",
+  "pred_index6", "pred_index7", "pred_index8", "pred_index9", "pred_index10",
+  "pred_index11", "pred_index12", "pred_index_adaptive1",
+  "pred_index_adaptive4", "pred_index_adaptive16",
+  "s_tree", "radix_spline16", "radix_spline32", "radix_spline64",
   "sd_array1", "sd_array2", "sd_array4", "sd_array8", "sd_array16",
   "sd_array32", "sd_array64", "sd_array128", "sd_array256", "sd_array512", 
+  "elias_fano16", "elias_fano64", "elias_fano256",
+  "compressed_sss16", "compressed_sss32", "compressed_sss64",
   "la_vector1", "la_vector2", "la_vector4", "la_vector8", "la_vector16",
   "la_vector32", "la_vector64", "la_vector128", "la_vector256", "la_vector512"};
 
+// lce_trace needs a query file (--trace) and is only part of "all" if there is
+// one
+std::vector<std::string> distributions{"uniform", "sequential", "zipf",
+                                       "exact", "lce_trace"};
+
 class benchmark {
  public:
   typedef uint64_t t_data_type;
@@ -59,10 +79,16 @@ class benchmark {
   fs::path data_path;
   std::vector<t_data_type> data;
 
-  std::vector<size_t> queries;
+  std::vector<t_data_type> queries;
   size_t num_queries = 1'000'000;
   bool no_pred = false;
   bool no_succ = false;
+  bool batch = false;
+  static constexpr size_t max_batch_size = 64;
+
+  std::string dist = "uniform";
+  std::vector<std::string> dists;
+  fs::path trace_path;
 
   std::string algorithm = "binsearch_std";
 
@@ -80,6 +106,32 @@ class benchmark {
                  algorithms);
       return false;
     }
+    // Check query distributions (comma separated)
+    for (size_t begin = 0; begin <= dist.size();) {
+      size_t end = std::min(dist.find(',', begin), dist.size());
+      std::string cur = dist.substr(begin, end - begin);
+      if (cur == "all") {
+        for (auto const& d : distributions) {
+          if (d != "lce_trace" || !trace_path.empty()) {
+            dists.push_back(d);
+          }
+        }
+      } else if (std::find(distributions.begin(), distributions.end(), cur) ==
+                 distributions.end()) {
+        fmt::print("Distribution {} is not specified.\n Use one of {} or all\n",
+                   cur, distributions);
+        return false;
+      } else {
+        dists.push_back(cur);
+      }
+      begin = end + 1;
+    }
+    if (std::find(dists.begin(), dists.end(), "lce_trace") != dists.end() &&
+        (!fs::is_regular_file(trace_path) || fs::file_size(trace_path) == 0)) {
+      fmt::print("Trace file {} is empty or does not exist.\n",
+                 trace_path.string());
+      return false;
+    }
     return true;
   }
 
@@ -94,19 +146,86 @@ class benchmark {
     fmt::print(" data_time={}", t.get());
   }
 
-  void load_queries() {
+  // Generate the queries of the given distribution:
+  // - uniform: uniform keys in [0, data.back()]
+  // - sequential: increasing keys with a fixed stride over [0, data.back()]
+  // - zipf: keys close to 1024 random entries, which are picked Zipf
+  //   distributed, i.e. few hot regions receive most queries
+  // - exact: random entries of the data (every query hits)
+  // - lce_trace: the positions of an lce query file (see gen_queries), as
+  //   lce_sss issues one successor query per position
+  void load_queries(std::string const& cur_dist) {
     lce::util::timer t;
     queries.resize(num_queries);
-    // std::random_device rd;
     std::mt19937 gen(1337);
-    std::uniform_int_distribution<uint64_t> distrib(0, data.back());
-    for (size_t i = 0; i < num_queries; ++i) {
-      queries[i] = distrib(gen);
+    if (cur_dist == "uniform") {
+      std::uniform_int_distribution<uint64_t> distrib(0, data.back());
+      for (size_t i = 0; i < num_queries; ++i) {
+        queries[i] = distrib(gen);
+      }
+    } else if (cur_dist == "sequential") {
+      const uint64_t stride = std::max<uint64_t>(1, data.back() / num_queries);
+      for (size_t i = 0; i < num_queries; ++i) {
+        queries[i] = (i * stride) % (data.back() + 1);
+      }
+    } else if (cur_dist == "zipf") {
+      constexpr size_t num_clusters = 1024;
+      constexpr uint64_t cluster_width = 4096;
+      std::uniform_int_distribution<size_t> entry(0, data.size() - 1);
+      std::vector<uint64_t> clusters(num_clusters);
+      std::vector<double> weights(num_clusters);
+      for (size_t i = 0; i < num_clusters; ++i) {
+        clusters[i] = data[entry(gen)];
+        weights[i] = 1.0 / (i + 1);
+      }
+      std::discrete_distribution<size_t> cluster(weights.begin(),
+                                                 weights.end());
+      std::uniform_int_distribution<uint64_t> offset(0, cluster_width - 1);
+      for (size_t i = 0; i < num_queries; ++i) {
+        queries[i] = clusters[cluster(gen)] + offset(gen);
+      }
+    } else if (cur_dist == "exact") {
+      std::uniform_int_distribution<size_t> entry(0, data.size() - 1);
+      for (size_t i = 0; i < num_queries; ++i) {
+        queries[i] = data[entry(gen)];
+      }
+    } else if (cur_dist == "lce_trace") {
+      // clone the positions until there are num_queries many
+      std::vector<size_t> trace = lce::util::load_vector<size_t>(trace_path);
+      for (size_t i = 0; i < num_queries; ++i) {
+        queries[i] = trace[i % trace.size()];
+      }
     }
+    fmt::print(" dist={}", cur_dist);
     fmt::print(" q_size={}", queries.size());
     fmt::print(" q_gen_time={}", t.get());
   }
 
+  // Time each query on its own and report percentiles of the latencies in ns
+  // (without the overhead of taking the timestamps).
+  template <typename F>
+  void benchmark_latency(std::string const& name, F&& query) {
+    typedef std::chrono::steady_clock clock;
+    const uint64_t overhead = lce::util::steady_clock_overhead_ns();
+    lce::util::latency_histogram<> hist;
+    size_t check_sum = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+      const auto begin = clock::now();
+      check_sum += query(queries[i]);
+      const auto end = clock::now();
+      const uint64_t ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+              .count();
+      hist.record(ns > overhead ? ns - overhead : 0);
+    }
+    fmt::print(" {}_p50={}", name, hist.percentile(0.5));
+    fmt::print(" {}_p90={}", name, hist.percentile(0.9));
+    fmt::print(" {}_p99={}", name, hist.percentile(0.99));
+    fmt::print(" {}_p999={}", name, hist.percentile(0.999));
+    fmt::print(" {}_max={}", name, hist.max());
+    fmt::print(" {}_lat_check_sum={}", name, check_sum);
+  }
+
   template <typename pred_ds_type>
   pred_ds_type benchmark_construction() {
 #ifdef ALX_BENCHMARK_SPACE
@@ -117,6 +236,10 @@ class benchmark {
     pred_ds_type pred_ds(data);
     fmt::print(" threads={}", omp_get_max_threads());
     fmt::print(" c_time={}", t.get());
+    if constexpr (requires { pred_ds.size_in_bytes(); }) {
+      fmt::print(" bytes_per_key={:.3f}",
+                 double(pred_ds.size_in_bytes()) / data.size());
+    }
 #ifdef ALX_BENCHMARK_SPACE
     fmt::print(" c_mem={}", malloc_count_current() - mem_before);
     fmt::print(" c_mempeak={}", malloc_count_peak() - mem_before);
@@ -127,23 +250,96 @@ class benchmark {
   template <typename pred_ds_type>
   void benchmark_queries(pred_ds_type& pred_ds) {
     if (!no_pred) {
+#ifdef LCE_BENCHMARK_PERF
+      lce::util::perf_counters perf;
+#endif
       lce::util::timer t;
       size_t check_sum = 0;
       for (size_t i = 0; i < queries.size(); ++i) {
         check_sum += pred_ds.predecessor(queries[i]).pos;
       }
-      fmt::print(" pred_time={}", t.get());
+      const size_t time = t.get();
+#ifdef LCE_BENCHMARK_PERF
+      perf.print_and_reset("pred");
+#endif
+      fmt::print(" pred_time={}", time);
+      fmt::print(" pred_ns={:.1f}", 1e6 * time / queries.size());
       fmt::print(" check_sum={}", check_sum);
+      benchmark_latency("pred", [&](t_data_type x) {
+        return pred_ds.predecessor(x).pos;
+      });
     }
 
     if (!no_succ) {
+#ifdef LCE_BENCHMARK_PERF
+      lce::util::perf_counters perf;
+#endif
       lce::util::timer t;
       size_t check_sum = 0;
       for (size_t i = 0; i < queries.size(); ++i) {
         check_sum += pred_ds.successor(queries[i]).pos;
       }
-      fmt::print(" succ_time={}", t.get());
+      const size_t time = t.get();
+#ifdef LCE_BENCHMARK_PERF
+      perf.print_and_reset("succ");
+#endif
+      fmt::print(" succ_time={}", time);
+      fmt::print(" succ_ns={:.1f}", 1e6 * time / queries.size());
       fmt::print(" check_sum={}", check_sum);
+      benchmark_latency("succ", [&](t_data_type x) {
+        return pred_ds.successor(x).pos;
+      });
+    }
+
+    if constexpr (requires(lce::pred::result* out) {
+                    pred_ds.successor_batch(queries.data(), 1, out);
+                  }) {
+      if (batch) {
+        benchmark_batch_queries<pred_ds_type>(pred_ds);
+      }
+    }
+  }
+
+  // Answer the queries in batches of 1, 2, 4, ..., 64 and report the time and
+  // the throughput (million queries per second) for each batch size.
+  template <typename pred_ds_type>
+  void benchmark_batch_queries(pred_ds_type& pred_ds) {
+    std::vector<lce::pred::result> res(max_batch_size);
+    for (size_t batch_size = 1; batch_size <= max_batch_size;
+         batch_size *= 2) {
+      if (!no_pred) {
+        lce::util::timer t;
+        size_t check_sum = 0;
+        for (size_t i = 0; i < queries.size(); i += batch_size) {
+          const size_t num = std::min(batch_size, queries.size() - i);
+          pred_ds.predecessor_batch(queries.data() + i, num, res.data());
+          for (size_t j = 0; j < num; ++j) {
+            check_sum += res[j].pos;
+          }
+        }
+        const size_t time = t.get();
+        fmt::print(" pred_batch{}_time={}", batch_size, time);
+        fmt::print(" pred_batch{}_mqps={:.2f}", batch_size,
+                   queries.size() / (1000.0 * std::max<size_t>(time, 1)));
+        fmt::print(" pred_batch{}_check_sum={}", batch_size, check_sum);
+      }
+
+      if (!no_succ) {
+        lce::util::timer t;
+        size_t check_sum = 0;
+        for (size_t i = 0; i < queries.size(); i += batch_size) {
+          const size_t num = std::min(batch_size, queries.size() - i);
+          pred_ds.successor_batch(queries.data() + i, num, res.data());
+          for (size_t j = 0; j < num; ++j) {
+            check_sum += res[j].pos;
+          }
+        }
+        const size_t time = t.get();
+        fmt::print(" succ_batch{}_time={}", batch_size, time);
+        fmt::print(" succ_batch{}_mqps={:.2f}", batch_size,
+                   queries.size() / (1000.0 * std::max<size_t>(time, 1)));
+        fmt::print(" succ_batch{}_check_sum={}", batch_size, check_sum);
+      }
     }
   }
 
@@ -158,11 +354,16 @@ class benchmark {
     fmt::print("RESULT algo={}", algo_name);
     load_data();
     pred_ds_type pred_ds = benchmark_construction<pred_ds_type>();
-
-    // Queries
-    load_queries();
-    benchmark_queries<pred_ds_type>(pred_ds);
     fmt::print("\n");
+
+    // Queries, one result line per distribution
+    for (auto const& cur_dist : dists) {
+      fmt::print("RESULT algo={}_queries", algo_name);
+      fmt::print(" data={}", data_path.filename().string());
+      load_queries(cur_dist);
+      benchmark_queries<pred_ds_type>(pred_ds);
+      fmt::print("\n");
+    }
   }
 };
 
@@ -179,6 +380,18 @@ int main(int argc, char** argv) {
                "Number of queries that are executed (default=1,000,000).");
   cp.add_flag("no_pred", b.no_pred, "Don't benchmark predecessor queries.");
   cp.add_flag("no_succ", b.no_succ, "Don't benchmark successor queries.");
+  cp.add_flag("batch", b.batch,
+              "Additionally benchmark batched queries with batch sizes 1, 2, "
+              "4, ..., 64 (for data structures that support batches).");
+
+  cp.add_string(
+      'd', "dist", b.dist,
+      fmt::format("Comma separated query distributions, or all. Options: {} "
+                  "(default=uniform).",
+                  distributions));
+  cp.add_path("trace", b.trace_path,
+              "lce query file (see gen_queries) whose positions are used as "
+              "queries for the lce_trace distribution.");
 
   cp.add_string(
       'a', "algorithm", b.algorithm,
@@ -196,6 +409,10 @@ int main(int argc, char** argv) {
   b.run<lce::pred::binsearch_cache<uint64_t>>("binsearch_cache");
   b.run<lce::pred::j_index<uint64_t>>("j_index");
   b.run<lce::pred::rank_index<uint64_t>>("rank_index");
+  b.run<lce::pred::s_tree_index<uint64_t>>("s_tree");
+  b.run<lce::pred::radix_spline_index<uint64_t, 16>>("radix_spline16");
+  b.run<lce::pred::radix_spline_index<uint64_t, 32>>("radix_spline32");
+  b.run<lce::pred::radix_spline_index<uint64_t, 64>>("radix_spline64");
 
   b.run<lce::pred::pred_index<uint64_t, 6, uint32_t>>("pred_index6");
   b.run<lce::pred::pred_index<uint64_t, 7, uint32_t>>("pred_index7");
@@ -204,6 +421,12 @@ int main(int argc, char** argv) {
   b.run<lce::pred::pred_index<uint64_t, 10, uint32_t>>("pred_index10");
   b.run<lce::pred::pred_index<uint64_t, 11, uint32_t>>("pred_index11");
   b.run<lce::pred::pred_index<uint64_t, 12, uint32_t>>("pred_index12");
+  b.run<lce::pred::adaptive_pred_index<uint64_t, uint32_t, 1>>(
+      "pred_index_adaptive1");
+  b.run<lce::pred::adaptive_pred_index<uint64_t, uint32_t, 4>>(
+      "pred_index_adaptive4");
+  b.run<lce::pred::adaptive_pred_index<uint64_t, uint32_t, 16>>(
+      "pred_index_adaptive16");
 
   b.run<lce::pred::pgm_index<uint64_t, 8>>("pgm_index8");
   b.run<lce::pred::pgm_index<uint64_t, 16>>("pgm_index16");
@@ -224,6 +447,14 @@ int main(int argc, char** argv) {
   b.run<lce::pred::sd_array_index<uint64_t, 512>>("sd_array512");
 #endif
 
+  b.run<lce::pred::elias_fano_index<uint64_t, 16>>("elias_fano16");
+  b.run<lce::pred::elias_fano_index<uint64_t, 64>>("elias_fano64");
+  b.run<lce::pred::elias_fano_index<uint64_t, 256>>("elias_fano256");
+
+  b.run<lce::pred::compressed_sss_index<uint64_t, 16>>("compressed_sss16");
+  b.run<lce::pred::compressed_sss_index<uint64_t, 32>>("compressed_sss32");
+  b.run<lce::pred::compressed_sss_index<uint64_t, 64>>("compressed_sss64");
+
 #ifdef LCE_BUILD_LA_VECTOR
   b.run<lce::pred::la_vector_index<uint64_t, 1>>("la_vector1");
   b.run<lce::pred::la_vector_index<uint64_t, 2>>("la_vector2");
@@ -7,11 +7,18 @@
  ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <omp.h>
 
+#include <algorithm>
 #include <limits>
 #include <numeric>
+#include <random>
+#include <set>
+#include <string_view>
+#include <unordered_map>
 
 #include "ds/lce_classic.hpp"
+#include "ds/lce_cross.hpp"
 #include "ds/lce_fp.hpp"
 #include "ds/lce_memcmp.hpp"
 #include "ds/lce_naive.hpp"
@@ -20,8 +27,20 @@
 #include "ds/lce_naive_wordwise_xor.hpp"
 #include "ds/lce_rk_prezza.hpp"
 #include "ds/lce_sss.hpp"
+#include "ds/lce_sss_bidirectional.hpp"
+#include "ds/lce_sss_dynamic.hpp"
+#include "ds/lce_sss_fp.hpp"
 #include "ds/lce_sss_naive.hpp"
 #include "ds/lce_sss_noss.hpp"
+#include "ds/periodicity.hpp"
+#include "ds/runs.hpp"
+#include "ds/sparse_suffix_sort.hpp"
+#include "ds/sparse_suffix_tree.hpp"
+#include "pred/compressed_sss_index.hpp"
+#include "pred/elias_fano_index.hpp"
+#include "pred/radix_spline_index.hpp"
+#include "pred/s_tree_index.hpp"
+#include "util/synthetic_text.hpp"
 
 template <typename ds_type>
 void test_empty_constructor() {
@@ -101,6 +120,33 @@ void test_suffix_sorting() {
   EXPECT_EQ(ds.is_leq_suffix(50, 0), false);
 }
 
+// The case that lce_case of the sss variants reports: the query (0, 1000) has
+// an lce of 1000 and can't be answered by the naive scan of the first 3*tau
+// symbols
+template <typename ds_type>
+void test_query_case() {
+  std::vector<uint8_t> text(3000);
+  uint64_t x = 1;
+  for (size_t i = 0; i < 1000; ++i) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    text[i] = text[i + 1000] = text[i + 2000] = x >> 56;
+  }
+  text[2000] = ~text[2000];
+
+  ds_type ds(text);
+  uint64_t c = 0;
+  uint64_t c_swapped = 0;
+  EXPECT_EQ(ds.lce_case(0, 1000, c), 1000);
+  EXPECT_NE(c, 0);
+  EXPECT_EQ(ds.lce_case(1000, 0, c_swapped), 1000);
+  EXPECT_EQ(c_swapped, c);
+  EXPECT_EQ(ds.lce_case(10, 11, c), ds.lce(10, 11));
+  EXPECT_EQ(c, 0);
+  c = 1;
+  EXPECT_EQ(ds.lce_case(5, 5, c), text.size() - 5);
+  EXPECT_EQ(c, 0);
+}
+
 template <typename ds_type, bool lr = true, bool mm = true, bool suf = true,
           bool upto = true>
 void test_variants() {
@@ -344,6 +390,18 @@ TEST(LceSssNaivePL, All) {
   // test_variants<lce::ds::lce_sss_naive<__int128_t, 16>>();
 }
 
+TEST(LceSssFP, All) {
+  test_empty_constructor<lce::ds::lce_sss_fp<uint8_t, 16>>();
+
+  test_simple<lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, false>>();
+  test_simple<lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, true>>();
+
+  test_variants<lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, false>, true, true,
+                true, false>();
+  test_variants<lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, true>, true, true,
+                true, false>();
+}
+
 TEST(LceSssNoSs, All) {
   test_empty_constructor<lce::ds::lce_sss_noss<uint8_t, 16>>();
 
@@ -455,6 +513,914 @@ TEST(LceSssPL, All) {
   // test_variants<lce::ds::lce_sss<__int128_t, 16>>();
 }
 
+TEST(LceSss, QueryCase) {
+  test_query_case<lce::ds::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_query_case<lce::ds::lce_sss<uint8_t, 16, uint32_t, true>>();
+  test_query_case<lce::ds::lce_sss<
+      uint8_t, 16, uint32_t, false,
+      lce::pred::compressed_sss_index<uint32_t>>>();
+  test_query_case<lce::ds::lce_sss_naive<uint8_t, 16, uint32_t, false>>();
+  test_query_case<lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, false>>();
+}
+
+// the synthetic texts stress the run handling of the sss variants, the
+// generated queries must be in the right buckets
+template <typename ds_type>
+void test_synthetic_texts() {
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 16, 1);
+    auto const queries = lce::util::generate_synthetic_queries(st, 50, 2);
+    lce::ds::lce_naive_wordwise_xor<uint8_t> naive(st.text);
+    ds_type ds(st.text);
+    for (size_t x = 0; x < queries.size(); ++x) {
+      for (size_t q = 0; q < queries[x].size(); q += 2) {
+        const size_t i = queries[x][q];
+        const size_t j = queries[x][q + 1];
+        const size_t lce = naive.lce(i, j);
+        ASSERT_EQ(std::min<size_t>(std::bit_width(lce), 20), x) << family;
+        ASSERT_EQ(ds.lce(i, j), lce) << family << " " << i << " " << j;
+      }
+    }
+  }
+}
+
+TEST(LceSss, SyntheticTexts) {
+  test_synthetic_texts<lce::ds::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_synthetic_texts<lce::ds::lce_sss<uint8_t, 16, uint32_t, true>>();
+  test_synthetic_texts<lce::ds::lce_sss<uint8_t, 64, uint32_t, false>>();
+}
+
+TEST(LceSssFP, SyntheticTexts) {
+  test_synthetic_texts<lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, false>>();
+  test_synthetic_texts<lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, true>>();
+}
+
+// long lce values span many blocks, so the exponential and binary search over
+// the prefix fingerprints run through all of their steps
+TEST(LceSssFP, LongLce) {
+  std::vector<uint8_t> text(1 << 16);
+  uint64_t x = 1;
+  for (size_t i = 0; i < text.size() / 2; ++i) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    text[i] = text[i + text.size() / 2] = x >> 62;
+  }
+  // mismatches at different distances behind the copied half
+  for (size_t k = 1; k < 12; ++k) {
+    text[text.size() / 2 + (size_t{1} << k) * 13] ^= 1;
+  }
+  lce::ds::lce_naive_wordwise_xor<uint8_t> naive(text);
+  lce::ds::lce_sss_fp<uint8_t, 16, uint32_t, false> ds(text);
+  std::mt19937_64 gen(1);
+  for (size_t q = 0; q < 10000; ++q) {
+    const size_t i = gen() % (text.size() / 2);
+    const size_t j = (q % 2 == 0) ? i + text.size() / 2 : gen() % text.size();
+    ASSERT_EQ(ds.lce(i, j), naive.lce(i, j)) << i << " " << j;
+  }
+  for (size_t i = 0; i < text.size() / 2; i += 97) {
+    ASSERT_EQ(ds.lce(i, i + text.size() / 2),
+              naive.lce(i, i + text.size() / 2))
+        << i;
+  }
+}
+
+TEST(LceSss, MemoryBreakdown) {
+  std::vector<uint8_t> text(1 << 16);
+  uint64_t x = 1;
+  for (auto& c : text) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    c = x >> 62;
+  }
+  lce::ds::lce_sss<uint8_t, 16, uint32_t> ds(text);
+  const auto mem = ds.memory_breakdown();
+  size_t sum = 0;
+  std::vector<std::string_view> names;
+  for (auto const& c : mem) {
+    sum += c.bytes;
+    names.push_back(c.name);
+  }
+  EXPECT_EQ(mem.total(), sum);
+  for (auto name : {"sss", "hi_index", "isa", "lcp", "rmq_levels"}) {
+    EXPECT_NE(std::find(names.begin(), names.end(), name), names.end())
+        << name;
+  }
+
+  lce::ds::lce_classic<uint8_t, uint32_t> classic(text);
+  EXPECT_GE(classic.memory_breakdown().total(), 2 * text.size() * 4);
+}
+
+// the sorted positions have to be a permutation of the input, in suffix
+// order and with the lcps of neighbours
+template <typename ds_type>
+void test_sparse_suffix_sort(std::vector<uint8_t> text,
+                             std::vector<uint32_t> const& positions) {
+  const std::vector<uint8_t> text_copy = text;
+  lce::ds::lce_naive_wordwise_xor<uint8_t> naive(text_copy);
+  ds_type ds(text);
+  std::vector<uint32_t> sorted = positions;
+  std::vector<uint32_t> lcp;
+  lce::ds::sparse_suffix_sort(ds, text, sorted, &lcp);
+
+  ASSERT_EQ(lcp.size(), sorted.size());
+  std::vector<uint32_t> expected = positions;
+  std::vector<uint32_t> actual = sorted;
+  std::sort(expected.begin(), expected.end());
+  std::sort(actual.begin(), actual.end());
+  ASSERT_EQ(actual, expected);
+  for (size_t k = 1; k < sorted.size(); ++k) {
+    ASSERT_TRUE(naive.is_leq_suffix(sorted[k - 1], sorted[k])) << k;
+    ASSERT_EQ(lcp[k], naive.lce(sorted[k - 1], sorted[k])) << k;
+  }
+}
+
+template <typename ds_type, bool large_group = true>
+void test_sparse_suffix_sort() {
+  std::mt19937_64 gen(3);
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 16, 1);
+    std::vector<uint32_t> positions;
+    for (uint32_t i = 0; i < st.text.size(); ++i) {
+      if (gen() % 7 == 0 || i + 16 > st.text.size()) {
+        positions.push_back(i);
+      }
+    }
+    test_sparse_suffix_sort<ds_type>(st.text, positions);
+  }
+
+  if constexpr (!large_group) {
+    return;
+  }
+  // one group that is too large for the merge sort
+  std::vector<uint32_t> positions;
+  for (uint32_t i = 0; i < (1 << 16); i += 2) {
+    positions.push_back(i);
+  }
+  test_sparse_suffix_sort<ds_type>(std::vector<uint8_t>(1 << 16, 'a'),
+                                   positions);
+  // several rounds of merging chunks, the last chunk is shorter
+  positions.clear();
+  for (uint32_t i = 0; i < 100'000; ++i) {
+    positions.push_back(i);
+  }
+  test_sparse_suffix_sort<ds_type>(std::vector<uint8_t>(1 << 17, 'a'),
+                                   positions);
+}
+
+TEST(LceSss, SparseSuffixSort) {
+  test_sparse_suffix_sort<lce::ds::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_sparse_suffix_sort<lce::ds::lce_sss<uint8_t, 64, uint32_t, true>>();
+  // lce queries reaching the end of the unary text take linear time in these
+  test_sparse_suffix_sort<lce::ds::lce_naive_wordwise_xor<uint8_t>, false>();
+  test_sparse_suffix_sort<lce::ds::lce_fp<uint8_t>, false>();
+}
+
+// lce_k_mismatch has to return the same extension and mismatches as a scan
+template <typename ds_type>
+void test_k_mismatch() {
+  for (auto const& family : {"dna", "periodic", "repetitive"}) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 14, 1);
+    auto const queries = lce::util::generate_synthetic_queries(st, 10, 2);
+    const std::vector<uint8_t> text = st.text;
+    ds_type ds(st.text);
+    for (auto const& bucket : queries) {
+      for (size_t q = 0; q < bucket.size(); q += 2) {
+        const size_t i = bucket[q];
+        const size_t j = bucket[q + 1];
+        for (size_t k : {0, 1, 2, 7, 32}) {
+          std::vector<size_t> expected;
+          size_t ext = 0;
+          while (std::max(i, j) + ext < text.size()) {
+            if (text[i + ext] != text[j + ext]) {
+              if (expected.size() == k) {
+                break;
+              }
+              expected.push_back(ext);
+            }
+            ++ext;
+          }
+          std::vector<size_t> mismatches;
+          ASSERT_EQ(ds.lce_k_mismatch(i, j, k, &mismatches), ext)
+              << family << " " << i << " " << j << " " << k;
+          ASSERT_EQ(mismatches, expected) << family << " " << i << " " << j;
+          ASSERT_EQ(ds.lce_k_mismatch(j, i, k), ext);
+        }
+      }
+    }
+  }
+}
+
+TEST(LceSss, KMismatch) {
+  test_k_mismatch<lce::ds::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_k_mismatch<lce::ds::lce_sss<uint8_t, 16, uint32_t, true>>();
+  test_k_mismatch<lce::ds::lce_sss<
+      uint8_t, 16, uint32_t, false,
+      lce::pred::compressed_sss_index<uint32_t>>>();
+}
+
+TEST(LceFP, KMismatch) {
+  test_k_mismatch<lce::ds::lce_fp<uint8_t>>();
+  test_k_mismatch<lce::ds::lce_fp<uint8_t, 64>>();
+}
+
+TEST(LceClassic, KMismatch) {
+  test_k_mismatch<lce::ds::lce_classic<uint8_t, uint32_t>>();
+}
+
+// lcs(i, j) has to be the lce of the reversed text at the mirrored positions
+template <typename ds_type>
+void test_bidirectional() {
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 15, 1);
+    auto const queries = lce::util::generate_synthetic_queries(st, 20, 2);
+    const size_t n = st.text.size();
+    const std::vector<uint8_t> reversed(st.text.rbegin(), st.text.rend());
+    lce::ds::lce_naive_wordwise_xor<uint8_t> naive(st.text);
+    lce::ds::lce_naive_wordwise_xor<uint8_t> naive_reversed(reversed);
+    ds_type ds(st.text);
+    for (auto const& bucket : queries) {
+      for (size_t q = 0; q < bucket.size(); q += 2) {
+        const size_t i = bucket[q];
+        const size_t j = bucket[q + 1];
+        ASSERT_EQ(ds.lce(i, j), naive.lce(i, j)) << family;
+        // the pairs of a repeat have long common suffixes as well
+        ASSERT_EQ(ds.lcs(i, j), naive_reversed.lce(n - 1 - i, n - 1 - j))
+            << family << " " << i << " " << j << " " << ds.mirrored();
+        ASSERT_EQ(ds.lcs(n - 1 - i, n - 1 - j), naive_reversed.lce(i, j))
+            << family << " " << i << " " << j;
+      }
+    }
+    ASSERT_EQ(ds.lcs(n - 1, n - 1), n);
+    ASSERT_EQ(ds.memory_saved(), n);
+    ASSERT_EQ(ds.memory_breakdown().total(),
+              ds.forward().memory_breakdown().total() +
+                  ds.backward().memory_breakdown().total());
+  }
+}
+
+// The mirrored set is a synchronizing set of the reversed text for the hash
+// w -> fp(reverse(w)), so it has to be consistent and dense on the reversed
+// text, but it is not the set that is built on the reversed text.
+template <uint64_t tau>
+void test_mirrored_sss() {
+  typedef lce::rolling_hash::sss<uint32_t, tau> sss_type;
+  size_t num_tested = 0;
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 15, 1);
+    const sss_type sync_set(st.text.data(), st.text.size(), false);
+    if (sync_set.has_runs()) {
+      continue;
+    }
+    ++num_tested;
+    const std::string reversed(st.text.rbegin(), st.text.rend());
+    const size_t n = reversed.size();
+    const sss_type mirrored_set = sss_type::mirrored(sync_set, n);
+    auto const& mirrored = mirrored_set.get_sss();
+    ASSERT_EQ(mirrored.size(), sync_set.size()) << family;
+    ASSERT_TRUE(std::is_sorted(mirrored.begin(), mirrored.end())) << family;
+    ASSERT_LE(mirrored.back(), n - 2 * tau) << family;
+
+    // consistency: equal windows of length 2 * tau are both in the set or not
+    std::vector<bool> in_set(n);
+    for (auto const i : mirrored) {
+      in_set[i] = true;
+    }
+    std::unordered_map<std::string_view, bool> window_in_set;
+    for (size_t i = 0; i <= n - 2 * tau; ++i) {
+      const std::string_view window(reversed.data() + i, 2 * tau);
+      auto const [it, inserted] = window_in_set.emplace(window, in_set[i]);
+      ASSERT_EQ(it->second, in_set[i]) << family << " " << i;
+    }
+
+    // density: a gap of more than tau is periodic with period at most tau / 3
+    for (size_t i = 0; i + 3 * tau - 1 <= n; ++i) {
+      if (std::find(in_set.begin() + i, in_set.begin() + i + tau, true) !=
+          in_set.begin() + i + tau) {
+        continue;
+      }
+      const std::string_view area(reversed.data() + i, 3 * tau - 1);
+      size_t period = 1;
+      while (area.substr(period) != area.substr(0, area.size() - period)) {
+        ++period;
+      }
+      ASSERT_LE(period, tau / 3) << family << " " << i;
+    }
+  }
+  ASSERT_GT(num_tested, 0);
+}
+
+TEST(LceSssBidirectional, MirroredSss) {
+  test_mirrored_sss<16>();
+  test_mirrored_sss<64>();
+}
+
+TEST(LceSssBidirectional, All) {
+  test_bidirectional<lce::ds::lce_sss_bidirectional<uint8_t, 16, uint32_t>>();
+  test_bidirectional<
+      lce::ds::lce_sss_bidirectional<uint8_t, 16, uint32_t, true>>();
+  test_bidirectional<lce::ds::lce_sss_bidirectional<
+      uint8_t, 64, uint32_t, false,
+      lce::pred::compressed_sss_index<uint32_t>>>();
+}
+
+// the scans of a reversed_text have to match the scans of a reversed copy
+TEST(ReversedText, NaiveScans) {
+  auto st = lce::util::generate_synthetic_text("repetitive", 1 << 12, 1);
+  const std::vector<uint8_t> reversed(st.text.rbegin(), st.text.rend());
+  const lce::util::reversed_text<uint8_t> view(st.text.data(), st.text.size());
+  typedef lce::ds::lce_naive_wordwise_xor<uint8_t> naive_type;
+  std::mt19937_64 gen(5);
+  for (size_t q = 0; q < 10000; ++q) {
+    const size_t i = gen() % reversed.size();
+    const size_t j = gen() % reversed.size();
+    if (i == j) {
+      continue;
+    }
+    ASSERT_EQ(view[i], reversed[i]);
+    ASSERT_EQ(naive_type::lce_uneq(view, view.size(), i, j),
+              naive_type::lce_uneq(reversed.data(), reversed.size(), i, j));
+    ASSERT_EQ(naive_type::lce_up_to(view, view.size(), i, j, 100),
+              naive_type::lce_up_to(reversed.data(), reversed.size(), i, j,
+                                    100));
+  }
+}
+
+// all runs by brute force: the maximal intervals with period p for p = 1, 2,
+// ..., which aren't already runs with a smaller period
+std::vector<lce::ds::run> naive_runs(std::vector<uint8_t> const& text) {
+  std::vector<lce::ds::run> runs;
+  std::set<std::pair<size_t, size_t>> found;
+  const size_t n = text.size();
+  for (size_t p = 1; 2 * p <= n; ++p) {
+    size_t begin = 0;
+    for (size_t k = 0; k + p <= n; ++k) {
+      if (k + p < n && text[k] == text[k + p]) {
+        continue;
+      }
+      // text[begin, k + p) has period p
+      if (k - begin >= p && found.emplace(begin, k + p).second) {
+        runs.push_back({begin, p, k + p - begin});
+      }
+      begin = k + 1;
+    }
+  }
+  std::sort(runs.begin(), runs.end());
+  return runs;
+}
+
+template <typename ds_type>
+void test_runs() {
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 12, 1);
+    const std::vector<uint8_t> text = st.text;
+    const auto expected = naive_runs(text);
+    for (int threads : {1, 4}) {
+      const int max_threads = omp_get_max_threads();
+      omp_set_num_threads(threads);
+      std::vector<lce::ds::run> runs;
+      {
+        ds_type ds(st.text);
+        runs = lce::ds::compute_runs(ds, st.text);
+      }
+      omp_set_num_threads(max_threads);
+      ASSERT_EQ(st.text, text);
+      ASSERT_EQ(runs.size(), expected.size()) << family << " " << threads;
+      ASSERT_EQ(runs, expected) << family << " " << threads;
+      ASSERT_EQ(lce::ds::decode_runs(lce::ds::encode_runs(runs)), runs);
+    }
+  }
+}
+
+TEST(LceSss, Runs) {
+  test_runs<lce::ds::lce_sss_bidirectional<uint8_t, 16, uint32_t>>();
+  test_runs<lce::ds::runs::with_reversed_copy<
+      lce::ds::lce_sss<uint8_t, 16, uint32_t, true>>>();
+}
+
+TEST(LceFP, Runs) {
+  test_runs<lce::ds::runs::with_reversed_copy<lce::ds::lce_fp<uint8_t>>>();
+}
+
+// smallest_period has to match a brute force search for substrings inside
+// and across the repeats of the synthetic texts
+template <typename ds_type>
+void test_periodicity() {
+  std::mt19937_64 gen(5);
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 14, 1);
+    const std::vector<uint8_t> text = st.text;
+    const size_t n = text.size();
+    ds_type ds(st.text);
+    auto has_period = [&](size_t i, size_t len, size_t p) {
+      for (size_t x = i; x + p < i + len; ++x) {
+        if (text[x] != text[x + p]) {
+          return false;
+        }
+      }
+      return true;
+    };
+    for (size_t q = 0; q < 400; ++q) {
+      size_t i = gen() % n;
+      size_t len = 1 + gen() % std::min<size_t>(n - i, 2000);
+      if (q % 2 == 0 && !st.repeats.empty()) {
+        auto const& r = st.repeats[gen() % st.repeats.size()];
+        i = r.begin + gen() % (r.end - r.begin);
+        len = std::min(1 + gen() % (r.end + r.shift - i), n - i);
+      }
+      size_t expected = 1;
+      while (expected < len && !has_period(i, len, expected)) {
+        ++expected;
+      }
+      expected = std::min(expected, len);
+      ASSERT_EQ(lce::ds::smallest_period(ds, i, len), expected)
+          << family << " " << i << " " << len;
+      ASSERT_EQ(lce::ds::smallest_period(ds, i, len, expected), expected);
+      if (expected > 1) {
+        ASSERT_EQ(lce::ds::smallest_period(ds, i, len, expected - 1), 0);
+      }
+      const size_t p = 1 + gen() % len;
+      ASSERT_EQ(lce::ds::is_periodic(ds, i, len, p), has_period(i, len, p))
+          << family << " " << i << " " << len << " " << p;
+      ASSERT_TRUE(lce::ds::is_periodic(ds, i, len, expected));
+    }
+  }
+}
+
+TEST(LceSss, Periodicity) {
+  test_periodicity<lce::ds::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_periodicity<lce::ds::lce_sss<uint8_t, 64, uint32_t, true>>();
+}
+
+TEST(LceFP, Periodicity) {
+  test_periodicity<lce::ds::lce_fp<uint8_t>>();
+}
+
+// A copy of text with random substitutions, insertions and deletions, padded
+// to a multiple of 8. origin[j] is the position of text that b[j] was copied
+// from or text.size() for inserted symbols.
+void mutated_copy(std::vector<uint8_t> const& text, size_t edits,
+                  std::mt19937_64& gen, std::vector<uint8_t>& b,
+                  std::vector<size_t>& origin) {
+  std::vector<size_t> pos(edits);
+  for (auto& p : pos) {
+    p = gen() % text.size();
+  }
+  std::sort(pos.begin(), pos.end());
+  b.clear();
+  origin.clear();
+  size_t p = 0;
+  for (size_t e : pos) {
+    for (; p < e; ++p) {
+      b.push_back(text[p]);
+      origin.push_back(p);
+    }
+    const size_t kind = gen() % 3;
+    if (kind != 2) {
+      b.push_back(gen() % 256);
+      origin.push_back(text.size());
+    }
+    if (kind != 1 && p == e) {
+      ++p;
+    }
+  }
+  for (; p < text.size(); ++p) {
+    b.push_back(text[p]);
+    origin.push_back(p);
+  }
+  while (b.size() % 8 != 0) {
+    b.push_back(0);
+    origin.push_back(text.size());
+  }
+}
+
+// lce(A, i, B, j) has to be the common prefix of A[i..] and B[j..], both for
+// random pairs and for pairs of positions copied from each other
+template <typename query_type>
+void test_cross(std::vector<uint8_t> const& a, std::vector<uint8_t> const& b,
+                std::vector<size_t> const& origin, query_type const& query) {
+  std::mt19937_64 gen(7);
+  auto naive = [&](size_t i, size_t j) {
+    size_t l = 0;
+    while (i + l < a.size() && j + l < b.size() && a[i + l] == b[j + l]) {
+      ++l;
+    }
+    return l;
+  };
+  for (size_t q = 0; q < 2000; ++q) {
+    const size_t i = gen() % a.size();
+    const size_t j = gen() % b.size();
+    ASSERT_EQ(query(i, j), naive(i, j)) << i << " " << j;
+    if (origin[j] < a.size()) {
+      ASSERT_EQ(query(origin[j], j), naive(origin[j], j)) << origin[j];
+      ASSERT_EQ(query(origin[j], j - j % 64), naive(origin[j], j - j % 64));
+    }
+  }
+  ASSERT_EQ(query(a.size() - 1, b.size() - 1),
+            naive(a.size() - 1, b.size() - 1));
+}
+
+TEST(LceSss, Cross) {
+  typedef lce::ds::lce_cross_reference<uint8_t, 16, uint32_t> reference_type;
+  typedef lce::ds::lce_cross_reference<uint8_t, 16, uint32_t, true>
+      reference_pl_type;
+  std::mt19937_64 gen(3);
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 15, 1);
+    std::vector<uint8_t> b;
+    std::vector<size_t> origin;
+    mutated_copy(st.text, 20, gen, b, origin);
+    reference_type reference(st.text);
+    reference_pl_type reference_pl(st.text);
+    for (int threads : {1, 4}) {
+      const int max_threads = omp_get_max_threads();
+      omp_set_num_threads(threads);
+      lce::ds::lce_cross_index<reference_type> index(reference, b);
+      lce::ds::lce_cross_index<reference_pl_type> index_pl(reference_pl, b);
+      omp_set_num_threads(max_threads);
+      test_cross(st.text, b, origin, [&](size_t i, size_t j) {
+        return lce::ds::lce(reference, i, index, j);
+      });
+      test_cross(st.text, b, origin, [&](size_t i, size_t j) {
+        return lce::ds::lce(reference_pl, i, index_pl, j);
+      });
+      ASSERT_GT(index.anchored(), 0.5) << family;
+    }
+    // a text unrelated to the reference has almost no anchors
+    std::vector<uint8_t> c(b.size());
+    for (auto& x : c) {
+      x = gen() % 256;
+    }
+    lce::ds::lce_cross_index<reference_type> index(reference, c);
+    test_cross(st.text, c, std::vector<size_t>(c.size(), st.text.size()),
+               [&](size_t i, size_t j) { return index.lce(i, j); });
+  }
+}
+
+TEST(LceFP, Cross) {
+  std::mt19937_64 gen(3);
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 15, 1);
+    std::vector<uint8_t> b;
+    std::vector<size_t> origin;
+    mutated_copy(st.text, 20, gen, b, origin);
+    // lce_fp transforms the texts, the copies are for the naive scans
+    const std::vector<uint8_t> a_copy = st.text;
+    const std::vector<uint8_t> b_copy = b;
+    {
+      lce::ds::lce_fp<uint8_t> ds_a(st.text);
+      lce::ds::lce_fp<uint8_t> ds_b(b);
+      test_cross(a_copy, b_copy, origin, [&](size_t i, size_t j) {
+        return lce::ds::lce(ds_a, i, ds_b, j);
+      });
+    }
+    ASSERT_EQ(st.text, a_copy);
+    ASSERT_EQ(b, b_copy);
+  }
+}
+
+// The search may match up to max_lce, then there is no block left to scan.
+TEST(LceFP, MatchToEnd) {
+  typedef lce::ds::lce_fp<uint8_t> ds_type;
+  std::mt19937_64 gen(12);
+  for (size_t max_lce : {64, 128, 200, 256, 1000}) {
+    // the last max_lce letters repeat a substring starting at 8
+    std::vector<uint8_t> text(2048);
+    for (auto& c : text) {
+      c = gen();
+    }
+    const size_t r = text.size() - max_lce;
+    std::copy(text.begin() + 8, text.begin() + 8 + max_lce, text.begin() + r);
+    const std::vector<uint8_t> copy = text;
+    ds_type ds(text);
+    ASSERT_EQ(ds.lce(8, r), max_lce);
+    ASSERT_EQ(ds.lce(r, 8), max_lce);
+
+    // a whole pattern that matches, its length is a multiple of 8 or not
+    for (size_t m : {max_lce, max_lce - 1}) {
+      const ds_type::pattern p(copy.data() + r, m);
+      ASSERT_EQ(ds.lce(p, 0, 8), m);
+      ASSERT_EQ(ds.lce(p, 0, r), m);
+    }
+  }
+}
+
+// lce(pattern, offset, i) has to be the common prefix of pattern[offset..]
+// and text[i..] for patterns copied from the text with one substitution
+TEST(LceFP, Pattern) {
+  typedef lce::ds::lce_fp<uint8_t> ds_type;
+  std::mt19937_64 gen(11);
+  for (auto const& family : {"dna", "periodic", "uniform"}) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 14, 1);
+    const std::vector<uint8_t> text = st.text;
+    ds_type ds(st.text);
+    std::vector<ds_type::pattern> patterns;
+    std::vector<std::vector<uint8_t>> copies;
+    for (size_t m : {0, 1, 7, 8, 33, 100, 1000, 5000}) {
+      const size_t from = gen() % (text.size() - m);
+      std::vector<uint8_t> p(text.begin() + from, text.begin() + from + m);
+      if (m != 0) {
+        p[gen() % m] ^= 1;
+      }
+      patterns.emplace_back(p);
+      copies.push_back(p);
+      for (size_t q = 0; q < 200; ++q) {
+        const size_t offset = (q == 0) ? m : gen() % (m + 1);
+        const size_t i = (q % 2 == 0) ? from + offset : gen() % text.size();
+        if (i >= text.size()) {
+          continue;
+        }
+        size_t lce = 0;
+        while (offset + lce < m && i + lce < text.size() &&
+               p[offset + lce] == text[i + lce]) {
+          ++lce;
+        }
+        ASSERT_EQ(ds.lce(patterns.back(), offset, i), lce)
+            << family << " " << m << " " << offset << " " << i;
+      }
+    }
+    // the patterns stay valid when the vector is reallocated or they are
+    // assigned
+    patterns.front() = ds_type::pattern(copies.back());
+    copies.front() = copies.back();
+    for (size_t k = 0; k < patterns.size(); ++k) {
+      ASSERT_EQ(patterns[k].size(), copies[k].size());
+      for (size_t x = 0; x < copies[k].size(); ++x) {
+        ASSERT_EQ(patterns[k][x], copies[k][x]);
+      }
+    }
+  }
+}
+
+// The sparse suffix array has to list the synchronizing positions in suffix
+// order with the lcps of neighbours, the intervals and occurrences have to
+// match a brute force search and the longest repeats may only miss tau - 1
+// letters of the longest repeat of the text.
+template <typename ds_type>
+void test_sparse_suffix_tree() {
+  typedef lce::ds::sparse_suffix_tree<ds_type> tree_type;
+  for (auto const& family : lce::util::synthetic_families) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 12, 1);
+    const std::vector<uint8_t> text = st.text;
+    const size_t n = text.size();
+    lce::ds::lce_naive_wordwise_xor<uint8_t> naive(text);
+    ds_type ds(st.text, true);
+    tree_type tree(ds);
+    const size_t tau = tree.tau();
+    ASSERT_EQ(tree.size(), ds.sparse_index().size()) << family;
+
+    std::set<size_t> positions;
+    for (size_t k = 0; k < tree.size(); ++k) {
+      positions.insert(tree.position(k));
+      ASSERT_EQ(tree.rank(ds.sparse_index().sa()[k]), k);
+      if (k == 0) {
+        continue;
+      }
+      const size_t l = tree.position(k - 1);
+      const size_t r = tree.position(k);
+      const size_t lcp = naive.lce(l, r);
+      ASSERT_EQ(tree.lcp(k), lcp) << family << " " << k;
+      ASSERT_TRUE(l + lcp == n || (r + lcp < n && text[l + lcp] < text[r + lcp]))
+          << family << " " << k;
+    }
+    ASSERT_EQ(positions.size(), tree.size()) << family;
+
+    size_t num_intervals = 0;
+    tree.for_each_interval(3 * tau, [&](auto const& iv) {
+      ++num_intervals;
+      ASSERT_LT(iv.lb, iv.rb);
+      ASSERT_GE(iv.lcp, 3 * tau);
+      size_t min_lcp = n;
+      for (size_t k = iv.lb + 1; k <= iv.rb; ++k) {
+        min_lcp = std::min<size_t>(min_lcp, tree.lcp(k));
+      }
+      ASSERT_EQ(min_lcp, iv.lcp) << family;
+      ASSERT_TRUE(iv.lb == 0 || tree.lcp(iv.lb) < iv.lcp) << family;
+      ASSERT_TRUE(iv.rb + 1 == tree.size() || tree.lcp(iv.rb + 1) < iv.lcp)
+          << family;
+      const auto shared = tree.sharing_prefix(iv.lb, iv.lcp);
+      ASSERT_EQ(shared.lb, iv.lb);
+      ASSERT_EQ(shared.rb, iv.rb);
+      ASSERT_EQ(shared.lcp, iv.lcp);
+    });
+    size_t expected_intervals = 0;
+    for (size_t k = 1; k < tree.size(); ++k) {
+      expected_intervals +=
+          tree.lcp(k) >= 3 * tau &&
+          (k + 1 == tree.size() || tree.lcp(k + 1) < tree.lcp(k));
+    }
+    ASSERT_LE(expected_intervals, num_intervals) << family;
+
+    auto const queries = lce::util::generate_synthetic_queries(st, 10, 2);
+    for (auto const& bucket : queries) {
+      for (size_t q = 0; q < bucket.size(); q += 2) {
+        const size_t i = bucket[q];
+        const auto succ = ds.successor(i);
+        // the second min_lcp can be answered with the tree, the first one may
+        // be too short and needs the scan
+        const size_t lce = naive.lce(i, bucket[q + 1]);
+        const size_t tree_lcp =
+            succ.exists ? std::max(lce, succ.pos - i + 2 * tau) : lce;
+        for (const size_t min_lcp : {lce, tree_lcp}) {
+          if (min_lcp > n - i) {
+            continue;
+          }
+          std::vector<size_t> found;
+          tree.for_each_occurrence(i, min_lcp,
+                                   [&](size_t x) { found.push_back(x); });
+          std::sort(found.begin(), found.end());
+          std::vector<size_t> expected;
+          for (size_t x = 0; x < n; ++x) {
+            if (naive.lce(i, x) >= min_lcp) {
+              expected.push_back(x);
+            }
+          }
+          ASSERT_EQ(found, expected) << family << " " << i << " " << min_lcp;
+        }
+      }
+    }
+
+    std::vector<size_t> sa(n);
+    std::iota(sa.begin(), sa.end(), 0);
+    std::sort(sa.begin(), sa.end(), [&](size_t l, size_t r) {
+      const size_t lce = naive.lce(l, r);
+      return l + lce == n || (r + lce < n && text[l + lce] < text[r + lce]);
+    });
+    size_t longest = 0;
+    for (size_t k = 1; k < n; ++k) {
+      longest = std::max(longest, naive.lce(sa[k - 1], sa[k]));
+    }
+    const auto repeats = tree.longest_repeats();
+    ASSERT_EQ(repeats.empty(), longest < 3 * tau) << family << " " << longest;
+    for (auto const& r : repeats) {
+      ASSERT_GE(r.positions.size(), 2);
+      ASSERT_LE(r.length, longest) << family;
+      ASSERT_GT(r.length + tau, longest) << family;
+      ASSERT_TRUE(std::is_sorted(r.positions.begin(), r.positions.end()));
+      for (auto p : r.positions) {
+        ASSERT_GE(naive.lce(r.positions.front(), p), r.length) << family;
+      }
+    }
+  }
+}
+
+TEST(LceSss, SparseSuffixTree) {
+  test_sparse_suffix_tree<lce::ds::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_sparse_suffix_tree<lce::ds::lce_sss<uint8_t, 16, uint32_t, true>>();
+  test_sparse_suffix_tree<lce::ds::lce_sss<
+      uint8_t, 16, uint32_t, false,
+      lce::pred::compressed_sss_index<uint32_t>>>();
+}
+
+// Return whether a and b have the same synchronizing positions.
+template <typename a_type, typename b_type>
+bool same_sync_positions(a_type const& a, b_type const& b) {
+  if (a.sparse_index().size() != b.sparse_index().size()) {
+    return false;
+  }
+  for (size_t k = 0; k < a.sparse_index().size(); ++k) {
+    if (a.sync_position(k) != b.sync_position(k)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// any tau has to answer the queries, taus that are too small or too large
+// for the text are clamped, the common ones and the others have to give the
+// synchronizing set of lce_sss with that tau
+TEST(LceSssDynamic, All) {
+  typedef lce::ds::lce_sss_dynamic<uint8_t> ds_type;
+  for (auto const& family : {"dna", "periodic"}) {
+    auto st = lce::util::generate_synthetic_text(family, 1 << 16, 1);
+    auto const queries = lce::util::generate_synthetic_queries(st, 20, 2);
+    lce::ds::lce_naive_wordwise_xor<uint8_t> naive(st.text);
+    const uint64_t max_tau = (st.text.size() - 1) / 5;
+    for (auto [tau, expected] : {std::pair<uint64_t, uint64_t>{64, 64},
+                                 {100, 100},
+                                 {10, 16},
+                                 {256, 256},
+                                 {uint64_t{1} << 20, max_tau}}) {
+      ds_type ds(st.text, tau);
+      ASSERT_EQ(ds.tau(), expected);
+      ASSERT_EQ(ds.size(), st.text.size());
+      for (auto const& bucket : queries) {
+        for (size_t q = 0; q < bucket.size(); q += 2) {
+          ASSERT_EQ(ds.lce(bucket[q], bucket[q + 1]),
+                    naive.lce(bucket[q], bucket[q + 1]))
+              << family << " " << tau;
+        }
+      }
+    }
+    ASSERT_TRUE(same_sync_positions(ds_type(st.text, 64).ds(),
+                                    lce::ds::lce_sss<uint8_t, 64>(st.text)))
+        << family;
+    ASSERT_TRUE(same_sync_positions(ds_type(st.text, 256).ds(),
+                                    lce::ds::lce_sss<uint8_t, 256>(st.text)))
+        << family;
+  }
+  ASSERT_EQ(ds_type::supported_tau(4096, 5 * 4096), 4095);
+  ASSERT_EQ(ds_type::supported_tau(100, 1 << 16), 100);
+  ASSERT_EQ(ds_type::supported_tau(1, 1 << 16), ds_type::min_tau);
+}
+
+// short queries cost the same for every tau, so the smallest index has to be
+// chosen, long queries are faster with a smaller tau if the index fits
+TEST(LceSssDynamic, AutoTune) {
+  typedef lce::ds::lce_sss_dynamic<uint8_t> ds_type;
+  std::mt19937_64 gen(3);
+  std::vector<uint8_t> text(1 << 16);
+  for (size_t i = 0; i < text.size(); ++i) {
+    text[i] = (i < (1 << 14)) ? gen() % 4 : text[i - (1 << 14)];
+  }
+  std::vector<size_t> short_queries;
+  std::vector<size_t> long_queries;
+  for (size_t q = 0; q < 1000; ++q) {
+    const size_t i = gen() % (1 << 15);
+    short_queries.push_back(i);
+    short_queries.push_back(i + 1);
+    long_queries.push_back(i);
+    long_queries.push_back(i + (1 << 14));
+  }
+
+  const auto unlimited = std::numeric_limits<size_t>::max();
+  auto tuning = ds_type::auto_tune(text, short_queries, unlimited);
+  ASSERT_EQ(tuning.estimates.size(), ds_type::taus.size());
+  size_t min_bytes = unlimited;
+  for (auto const& e : tuning.estimates) {
+    ASSERT_GT(e.density, 0);
+    ASSERT_GT(e.bytes, 0);
+    min_bytes = std::min(min_bytes, e.bytes);
+  }
+  for (auto const& e : tuning.estimates) {
+    if (e.tau == tuning.tau) {
+      ASSERT_EQ(e.bytes, min_bytes);
+    }
+  }
+
+  tuning = ds_type::auto_tune(text, long_queries, unlimited);
+  ASSERT_EQ(tuning.tau, 64);
+  const size_t budget = tuning.estimates[2].bytes;
+  tuning = ds_type::auto_tune(text, long_queries, budget);
+  for (auto const& e : tuning.estimates) {
+    if (e.tau == tuning.tau) {
+      ASSERT_LE(e.bytes, budget);
+    } else if (e.tau < tuning.tau) {
+      ASSERT_GT(e.bytes, budget);
+    }
+  }
+  tuning = ds_type::auto_tune(text, long_queries, 0);
+  for (auto const& e : tuning.estimates) {
+    if (e.tau == tuning.tau) {
+      ASSERT_EQ(e.bytes, min_bytes);
+    }
+  }
+
+  ds_type ds(text, tuning.tau);
+  ASSERT_EQ(ds.tau(), tuning.tau);
+  ASSERT_EQ(ds.lce(long_queries[0], long_queries[1]),
+            lce::ds::lce_naive_wordwise_xor<uint8_t>(text).lce(
+                long_queries[0], long_queries[1]));
+}
+
+TEST(LceSssSTree, All) {
+  typedef lce::pred::s_tree_index<uint32_t> pred_type;
+  test_empty_constructor<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>>();
+
+  test_simple<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>>();
+  test_simple<lce::ds::lce_sss<uint8_t, 16, uint32_t, true, pred_type>>();
+
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>,
+                true, true, true, false>();
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, true, pred_type>,
+                true, true, true, false>();
+}
+
+TEST(LceSssEliasFano, All) {
+  typedef lce::pred::elias_fano_index<uint32_t> pred_type;
+  test_simple<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>>();
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>,
+                true, true, true, false>();
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, true, pred_type>,
+                true, true, true, false>();
+}
+
+TEST(LceSssRadixSpline, All) {
+  typedef lce::pred::radix_spline_index<uint32_t, 4, 8> pred_type;
+  test_simple<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>>();
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>,
+                true, true, true, false>();
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, true, pred_type>,
+                true, true, true, false>();
+}
+
+TEST(LceSssCompressed, All) {
+  typedef lce::pred::compressed_sss_index<uint32_t, 4> pred_type;
+  test_empty_constructor<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>>();
+  test_simple<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>>();
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, false, pred_type>,
+                true, true, true, false>();
+  test_variants<lce::ds::lce_sss<uint8_t, 16, uint32_t, true, pred_type>,
+                true, true, true, false>();
+}
+
 TEST(LceMemcmp, SS) {
   test_empty_constructor<lce::ds::lce_memcmp>();
   test_suffix_sorting<lce::ds::lce_memcmp>();
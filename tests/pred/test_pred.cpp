@@ -10,11 +10,18 @@
 
 #include <limits>
 #include <numeric>
+#include <random>
 
+#include "pred/adaptive_pred_index.hpp"
+#include "pred/binsearch_cache.hpp"
 #include "pred/binsearch_std.hpp"
+#include "pred/compressed_sss_index.hpp"
+#include "pred/elias_fano_index.hpp"
 #include "pred/j_index.hpp"
 #include "pred/pgm_index.hpp"
 #include "pred/pred_index.hpp"
+#include "pred/radix_spline_index.hpp"
+#include "pred/s_tree_index.hpp"
 
 template <typename pred_ds_type>
 void test_empty_constructor() {
@@ -140,6 +147,84 @@ void test_simple_safe() {
   data = data_copy;
 }
 
+// Compare against std::lower_bound and std::upper_bound on random data that
+// is large enough to span several levels of the tree based structures. Unless
+// unique is set, the data keeps its duplicates: the successor is the first
+// and the predecessor the last of equal keys.
+template <typename pred_ds_type>
+void test_random_safe(size_t size, uint64_t universe, bool unique = true) {
+  typedef typename pred_ds_type::data_type data_type;
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<uint64_t> distrib(0, universe);
+
+  std::vector<data_type> data(size);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = distrib(gen);
+  }
+  std::sort(data.begin(), data.end());
+  if (unique) {
+    data.erase(std::unique(data.begin(), data.end()), data.end());
+  }
+
+  pred_ds_type ds(data);
+  std::vector<data_type> queries(10'000);
+  std::vector<lce::pred::result> expected_pred(queries.size());
+  std::vector<lce::pred::result> expected_succ(queries.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    data_type x = queries[i] = distrib(gen);
+    // include the bounds
+    if (i == 0) x = queries[i] = data.front();
+    if (i == 1) x = queries[i] = data.back();
+    auto succ = std::lower_bound(data.begin(), data.end(), x);
+    if (succ == data.end()) {
+      EXPECT_EQ(ds.successor(x).exists, false);
+      expected_succ[i] = ds.successor(x);
+    } else {
+      expected_succ[i] = {true, size_t(succ - data.begin())};
+      EXPECT_EQ(ds.successor(x), expected_succ[i]);
+    }
+    auto pred = std::upper_bound(data.begin(), data.end(), x);
+    if (pred == data.begin()) {
+      EXPECT_EQ(ds.predecessor(x).exists, false);
+      expected_pred[i] = ds.predecessor(x);
+    } else {
+      expected_pred[i] = {true, size_t(pred - data.begin() - 1)};
+      EXPECT_EQ(ds.predecessor(x), expected_pred[i]);
+    }
+  }
+
+  // Batched queries must give the same results for all batch sizes
+  if constexpr (requires(lce::pred::result* out) {
+                  ds.successor_batch(queries.data(), 1, out);
+                }) {
+    for (size_t batch_size : {1, 2, 7, 16, 64}) {
+      std::vector<lce::pred::result> res(queries.size());
+      for (size_t i = 0; i < queries.size(); i += batch_size) {
+        const size_t num = std::min(batch_size, queries.size() - i);
+        ds.predecessor_batch(queries.data() + i, num, res.data() + i);
+      }
+      for (size_t i = 0; i < queries.size(); ++i) {
+        if (expected_pred[i].exists) {
+          EXPECT_EQ(res[i], expected_pred[i]);
+        } else {
+          EXPECT_EQ(res[i].exists, false);
+        }
+      }
+      for (size_t i = 0; i < queries.size(); i += batch_size) {
+        const size_t num = std::min(batch_size, queries.size() - i);
+        ds.successor_batch(queries.data() + i, num, res.data() + i);
+      }
+      for (size_t i = 0; i < queries.size(); ++i) {
+        if (expected_succ[i].exists) {
+          EXPECT_EQ(res[i], expected_succ[i]);
+        } else {
+          EXPECT_EQ(res[i].exists, false);
+        }
+      }
+    }
+  }
+}
+
 TEST(PredBinsearchStd, All) {
   test_empty_constructor<lce::pred::binsearch_std<uint64_t>>();
   test_simple<lce::pred::binsearch_std<unsigned char>>();
@@ -149,6 +234,13 @@ TEST(PredBinsearchStd, All) {
   test_simple<lce::pred::binsearch_std<uint64_t>>();
   test_simple<lce::pred::binsearch_std<int64_t>>();
   test_simple<lce::pred::binsearch_std<__uint128_t>>();
+  test_random_safe<lce::pred::binsearch_std<uint64_t>>(100'000, 1'000'000);
+}
+
+TEST(PredBinsearchCache, Safe) {
+  test_simple_safe<lce::pred::binsearch_cache<uint32_t>>();
+  test_simple_safe<lce::pred::binsearch_cache<uint64_t>>();
+  test_random_safe<lce::pred::binsearch_cache<uint64_t>>(100'000, 1'000'000);
 }
 
 TEST(PredIndex, Safe) {
@@ -160,6 +252,59 @@ TEST(PredIndex, Safe) {
   test_simple_safe<lce::pred::pred_index<uint32_t, 7, uint32_t>>();
   test_simple_safe<lce::pred::pred_index<uint32_t, 7, uint32_t>>();
   test_simple_safe<lce::pred::pred_index<uint32_t, 7, uint32_t>>();
+  test_random_safe<lce::pred::pred_index<uint32_t, 7, uint32_t>>(100'000,
+                                                                 1'000'000);
+  test_random_safe<lce::pred::pred_index<uint64_t, 12, uint32_t>>(100'000,
+                                                                  1'000'000);
+}
+
+// pred_index with the low bits passed to the constructor
+template <typename T, size_t t_lo_bits>
+struct pred_index_dynamic
+    : lce::pred::pred_index<T, lce::pred::dynamic_lo_bits, uint32_t> {
+  typedef lce::pred::pred_index<T, lce::pred::dynamic_lo_bits, uint32_t> base;
+
+  pred_index_dynamic() = default;
+
+  pred_index_dynamic(T const* data, size_t size)
+      : base(data, size, t_lo_bits) {}
+
+  template <typename C>
+  pred_index_dynamic(C const& container) : base(container, t_lo_bits) {}
+};
+
+TEST(PredIndex, DynamicLoBits) {
+  test_simple_safe<pred_index_dynamic<uint32_t, 7>>();
+  test_random_safe<pred_index_dynamic<uint32_t, 7>>(100'000, 1'000'000);
+  test_random_safe<pred_index_dynamic<uint64_t, 12>>(100'000, 1'000'000);
+}
+
+TEST(AdaptivePredIndex, Safe) {
+  test_empty_constructor<lce::pred::adaptive_pred_index<uint64_t>>();
+  test_simple_safe<lce::pred::adaptive_pred_index<uint8_t>>();
+  test_simple_safe<lce::pred::adaptive_pred_index<uint32_t>>();
+  test_simple_safe<lce::pred::adaptive_pred_index<uint64_t>>();
+  test_simple_safe<lce::pred::adaptive_pred_index<uint64_t, uint32_t, 1>>();
+  test_random_safe<lce::pred::adaptive_pred_index<uint32_t>>(100'000,
+                                                             1'000'000);
+  test_random_safe<lce::pred::adaptive_pred_index<uint64_t, uint64_t, 16>>(
+      100'000, 1'000'000);
+  // sparse data, pred_index would need a table of the size of the universe
+  test_random_safe<lce::pred::adaptive_pred_index<uint64_t>>(
+      100'000, std::numeric_limits<uint64_t>::max() >> 1);
+  // dense data, almost every key of the universe occurs
+  test_random_safe<lce::pred::adaptive_pred_index<uint64_t>>(100'000, 50'000);
+}
+
+TEST(AdaptivePredIndex, TableSize) {
+  std::mt19937_64 gen(7);
+  std::vector<uint64_t> data(10'000);
+  for (auto& x : data) x = (uint64_t{1} << 40) + gen() % (uint64_t{1} << 36);
+  std::sort(data.begin(), data.end());
+
+  // the table only depends on the number of keys
+  lce::pred::adaptive_pred_index<uint64_t, uint32_t, 4> ds(data);
+  EXPECT_LE(ds.size_in_bytes(), data.size() * sizeof(uint32_t));
 }
 
 TEST(JIndex, Safe) {
@@ -171,6 +316,7 @@ TEST(JIndex, Safe) {
   test_simple_safe<lce::pred::j_index<uint64_t>>();
   test_simple_safe<lce::pred::j_index<int64_t>>();
   test_simple_safe<lce::pred::j_index<__uint128_t>>();
+  test_random_safe<lce::pred::j_index<uint64_t>>(100'000, 1'000'000);
 }
 
 TEST(PGMIndex, Safe) {
@@ -182,4 +328,119 @@ TEST(PGMIndex, Safe) {
   test_simple_safe<lce::pred::pgm_index<uint64_t, 32>>();
   test_simple_safe<lce::pred::pgm_index<int64_t, 32>>();
   //test_simple_safe<lce::pred::pgm_index<__uint128_t, 32>>();
+  test_random_safe<lce::pred::pgm_index<uint64_t, 32>>(100'000, 1'000'000);
+}
+
+TEST(STreeIndex, Safe) {
+  test_empty_constructor<lce::pred::s_tree_index<uint64_t>>();
+  test_simple_safe<lce::pred::s_tree_index<uint8_t>>();
+  test_simple_safe<lce::pred::s_tree_index<uint32_t>>();
+  test_simple_safe<lce::pred::s_tree_index<uint64_t>>();
+  test_random_safe<lce::pred::s_tree_index<uint32_t>>(100'000, 1'000'000);
+  test_random_safe<lce::pred::s_tree_index<uint32_t>>(
+      100'000, std::numeric_limits<uint32_t>::max());
+  test_random_safe<lce::pred::s_tree_index<uint64_t>>(
+      100'000, std::numeric_limits<uint64_t>::max());
+  test_random_safe<lce::pred::s_tree_index<uint64_t>>(4'097, 10'000);
+}
+
+TEST(RadixSplineIndex, Safe) {
+  test_empty_constructor<lce::pred::radix_spline_index<uint64_t>>();
+  test_simple_safe<lce::pred::radix_spline_index<uint8_t>>();
+  test_simple_safe<lce::pred::radix_spline_index<uint32_t>>();
+  test_simple_safe<lce::pred::radix_spline_index<uint64_t, 2, 4>>();
+  test_random_safe<lce::pred::radix_spline_index<uint32_t>>(100'000,
+                                                            1'000'000);
+  test_random_safe<lce::pred::radix_spline_index<uint64_t, 4, 10>>(
+      100'000, std::numeric_limits<uint64_t>::max() >> 12);
+  test_random_safe<lce::pred::radix_spline_index<uint64_t, 64>>(100'000,
+                                                                50'000);
+}
+
+TEST(RadixSplineIndex, VaryingDensity) {
+  // dense runs between sparse regions, as in string synchronizing sets of
+  // texts with runs
+  std::mt19937_64 gen(3);
+  std::vector<uint64_t> data;
+  uint64_t pos = 0;
+  for (size_t i = 0; i < 200; ++i) {
+    for (size_t j = 0; j < 500; ++j) data.push_back(pos += 1 + gen() % 2);
+    for (size_t j = 0; j < 50; ++j) data.push_back(pos += 1 + gen() % 100'000);
+  }
+  lce::pred::radix_spline_index<uint64_t, 8> ds(data);
+  std::uniform_int_distribution<uint64_t> distrib(0, data.back());
+  for (size_t i = 0; i < 10'000; ++i) {
+    const uint64_t x = distrib(gen);
+    EXPECT_EQ(ds.successor(x).pos,
+              size_t(std::lower_bound(data.begin(), data.end(), x) -
+                     data.begin()));
+  }
+}
+
+TEST(EliasFanoIndex, Safe) {
+  test_empty_constructor<lce::pred::elias_fano_index<uint64_t>>();
+  test_simple_safe<lce::pred::elias_fano_index<uint8_t>>();
+  test_simple_safe<lce::pred::elias_fano_index<uint32_t>>();
+  test_simple_safe<lce::pred::elias_fano_index<uint64_t>>();
+  test_simple_safe<lce::pred::elias_fano_index<uint64_t, 4>>();
+  test_random_safe<lce::pred::elias_fano_index<uint32_t>>(100'000, 1'000'000);
+  test_random_safe<lce::pred::elias_fano_index<uint64_t, 8>>(100'000,
+                                                              1'000'000);
+  test_random_safe<lce::pred::elias_fano_index<uint64_t>>(
+      100'000, std::numeric_limits<uint64_t>::max() >> 1);
+  // dense data without low bits
+  test_random_safe<lce::pred::elias_fano_index<uint64_t>>(100'000, 50'000);
+  // duplicates, equal entries in the same bucket
+  test_random_safe<lce::pred::elias_fano_index<uint64_t>>(100'000, 50'000,
+                                                           false);
+}
+
+TEST(EliasFanoIndex, Access) {
+  std::mt19937_64 gen(7);
+  std::vector<uint64_t> data(10'000);
+  for (auto& x : data) x = 1'000 + gen() % 10'000'000;
+  std::sort(data.begin(), data.end());
+
+  lce::pred::elias_fano_index<uint64_t> ds(data);
+  // copies and moves have to keep the select structure intact
+  lce::pred::elias_fano_index<uint64_t> ds_copy = ds;
+  lce::pred::elias_fano_index<uint64_t> ds_moved = std::move(ds);
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(ds_copy.access(i), data[i]);
+    EXPECT_EQ(ds_moved[i], data[i]);
+  }
+}
+
+TEST(CompressedSssIndex, Safe) {
+  test_empty_constructor<lce::pred::compressed_sss_index<uint64_t>>();
+  test_simple_safe<lce::pred::compressed_sss_index<uint8_t>>();
+  test_simple_safe<lce::pred::compressed_sss_index<uint32_t>>();
+  test_simple_safe<lce::pred::compressed_sss_index<uint64_t>>();
+  test_simple_safe<lce::pred::compressed_sss_index<uint64_t, 4>>();
+  test_random_safe<lce::pred::compressed_sss_index<uint32_t>>(100'000,
+                                                               1'000'000);
+  test_random_safe<lce::pred::compressed_sss_index<uint64_t, 7>>(100'000,
+                                                                  1'000'000);
+  // deltas of up to 64 bits, which cross word borders
+  test_random_safe<lce::pred::compressed_sss_index<uint64_t>>(
+      100'000, std::numeric_limits<uint64_t>::max() >> 1);
+  // dense data with deltas of one
+  test_random_safe<lce::pred::compressed_sss_index<uint64_t>>(100'000, 50'000);
+  // duplicates, which are zero deltas
+  test_random_safe<lce::pred::compressed_sss_index<uint64_t>>(100'000, 50'000,
+                                                               false);
+}
+
+TEST(CompressedSssIndex, Access) {
+  std::mt19937_64 gen(7);
+  std::vector<uint64_t> data(10'000);
+  for (auto& x : data) x = 1'000 + gen() % 10'000'000;
+  std::sort(data.begin(), data.end());
+
+  lce::pred::compressed_sss_index<uint64_t> ds(data);
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(ds.access(i), data[i]);
+  }
+  // deltas of about 10 bits instead of 64 bits per entry
+  EXPECT_LT(ds.size_in_bytes(), data.size() * sizeof(uint64_t) / 2);
 }
\ No newline at end of file